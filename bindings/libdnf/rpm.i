@@ -1,6 +1,7 @@
 %module rpm
 
 %include <exception.i>
+%include <std_shared_ptr.i>
 %include <std_string.i>
 
 #if defined(SWIGPYTHON)
@@ -35,7 +36,10 @@
 #define CV __perl_CV
 
 %include "libdnf/rpm/checksum.hpp"
+%shared_ptr(libdnf::rpm::SharedRepoCache)
+wrap_unique_ptr(SolvSackUniquePtr, libdnf::rpm::SolvSack);
 %include "libdnf/rpm/solv_sack.hpp"
+%template(VectorRepoMemoryUsage) std::vector<libdnf::rpm::RepoMemoryUsage>;
 %include "libdnf/rpm/reldep.hpp"
 
 %rename(next) libdnf::rpm::ReldepListIterator::operator++();
@@ -57,11 +61,13 @@
 
 %template(RepoWeakPtr) libdnf::WeakPtr<libdnf::rpm::Repo, false>;
 %template(SetRepoWeakPtr) libdnf::Set<libdnf::rpm::RepoWeakPtr>;
-%template(SackQueryRepoWeakPtr) libdnf::sack::Query<libdnf::rpm::RepoWeakPtr>;
+%template(SortedVectorSetRepoWeakPtr) libdnf::Set<libdnf::rpm::RepoWeakPtr, std::vector<libdnf::rpm::RepoWeakPtr>>;
+%template(SackQueryRepoWeakPtr) libdnf::sack::Query<libdnf::rpm::RepoWeakPtr, std::vector<libdnf::rpm::RepoWeakPtr>>;
 
 %include "libdnf/rpm/repo_query.hpp"
 %template(SackRepoRepoQuery) libdnf::sack::Sack<libdnf::rpm::Repo, libdnf::rpm::RepoQuery>;
 %include "libdnf/rpm/repo_sack.hpp"
+%template(VectorRepoLoadResult) std::vector<libdnf::rpm::RepoLoadResult>;
 
 add_iterator(PackageSet)
 add_iterator(ReldepList)
@@ -30,6 +30,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 namespace libdnf::sack {
 
 
+/// @throw std::runtime_error if `cmp` cannot be used to compare integers
+void check_int64_cmp(QueryCmp cmp);
+
 bool match_int64(int64_t value, QueryCmp cmp, int64_t pattern);
 bool match_int64(int64_t value, QueryCmp cmp, const std::vector<int64_t> & patterns);
 bool match_int64(const std::vector<int64_t> & values, QueryCmp cmp, int64_t pattern);
@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "query_cmp.hpp"
 
+#include <regex>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,40 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 namespace libdnf::sack {
 
 
+/// Patterns prepared for matching many values using the same comparison.
+/// Regular expressions are compiled once in the constructor, globs without wildcards are compared as plain strings.
+/// A value matches if it matches any of the patterns. Negated comparisons are evaluated per pattern.
+class StringMatcher {
+public:
+    /// @throw std::runtime_error if `cmp` is not a string comparison
+    /// @throw std::regex_error if a regular expression pattern is invalid
+    StringMatcher(QueryCmp cmp, const std::string & pattern);
+    StringMatcher(QueryCmp cmp, const std::vector<std::string> & patterns);
+
+    bool match(const std::string & value) const;
+
+    /// Returns `true` if any of the `values` matches.
+    bool match(const std::vector<std::string> & values) const;
+
+    /// A `nullptr` value does not match any pattern.
+    bool match(const char * value) const;
+
+private:
+    struct Pattern {
+        QueryCmp cmp;  // comparison without the NOT flag
+        std::string text;
+        std::regex regex;
+    };
+
+    void add_pattern(const std::string & pattern);
+    static bool match(const char * value, std::size_t value_len, const Pattern & pattern);
+
+    QueryCmp cmp;
+    bool negate{false};
+    std::vector<Pattern> patterns;
+};
+
+
 bool match_string(const std::string & value, QueryCmp cmp, const std::string & pattern);
 bool match_string(const std::string & value, QueryCmp cmp, const std::vector<std::string> & patterns);
 bool match_string(const std::vector<std::string> & values, QueryCmp cmp, const std::string & pattern);
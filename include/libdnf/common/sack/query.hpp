@@ -28,10 +28,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/utils/exception.hpp"
 #include "libdnf/utils/set.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 
@@ -39,8 +41,12 @@ namespace libdnf::sack {
 
 
 /// Query is a Set with filtering capabilities.
-template <typename T>
-class Query : public Set<T> {
+/// The filters are deferred: `ifilter()` only records the filter and the objects are tested when the query is next
+/// accessed (size(), list(), copy, set operation, ...). A getter therefore reads the state of the objects
+/// (e.g. whether a Repo is enabled, its name) at that access, not at the time of the `ifilter()` call.
+/// If a getter throws, the exception is thrown from the access and the query stays unfiltered.
+template <typename T, typename Container = std::set<T>>
+class Query : public Set<T, Container> {
 public:
     class UnsupportedOperation : public LogicError {
     public:
@@ -58,8 +64,8 @@ public:
     using FilterFunctionVectorString = std::vector<std::string>(const T & obj);
 
     Query() = default;
-    explicit Query(const Set<T> & src_set) : Set<T>::Set(src_set) {}
-    explicit Query(Set<T> && src_set) : Set<T>::Set(std::move(src_set)) {}
+    explicit Query(const Set<T, Container> & src_set) : Set<T, Container>::Set(src_set) {}
+    explicit Query(Set<T, Container> && src_set) : Set<T, Container>::Set(std::move(src_set)) {}
 
     void ifilter(std::string (*getter)(const T &), QueryCmp cmp, const std::string & pattern);
     void ifilter(std::vector<std::string> (*getter)(const T &), QueryCmp cmp, const std::string & pattern);
@@ -85,139 +91,85 @@ public:
     }
 
     /// List all objects matching the query.
-    const std::set<T> & list() const noexcept { return get_data(); }
+    const Container & list() const { return get_data(); }
 
     // operators; OR at least
     // copy()
-    using Set<T>::get_data;
+    using Set<T, Container>::get_data;
+
+private:
+    /// Keeps only the objects for which `match` returns true.
+    /// The filtering is deferred, filters chained before the next access to the query are applied in a single pass.
+    /// `match` must not refer to any local variables of the caller.
+    template <typename Predicate>
+    void filter(Predicate match) {
+        this->add_pending_filter(std::move(match));
+    }
 };
 
 
-template <typename T>
-inline void Query<T>::ifilter(Query<T>::FilterFunctionString * getter, QueryCmp cmp, const std::string & pattern) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (match_string(value, cmp, pattern)) {
-            ++it;
-        } else {
-            // TODO(jrohel): Modifying of iterated dataset. Performance? Can be implement better?
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    Query<T, Container>::FilterFunctionString * getter, QueryCmp cmp, const std::string & pattern) {
+    filter([getter, matcher = StringMatcher(cmp, pattern)](const T & obj) { return matcher.match(getter(obj)); });
 }
 
-
-template <typename T>
-inline void Query<T>::ifilter(
-    Query<T>::FilterFunctionVectorString * getter, QueryCmp cmp, const std::string & pattern) {
-
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto values = getter(*it);
-        if (match_string(values, cmp, pattern)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    Query<T, Container>::FilterFunctionVectorString * getter, QueryCmp cmp, const std::string & pattern) {
+    filter([getter, matcher = StringMatcher(cmp, pattern)](const T & obj) { return matcher.match(getter(obj)); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(
-    Query<T>::FilterFunctionString * getter, QueryCmp cmp, const std::vector<std::string> & patterns) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (match_string(value, cmp, patterns)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    Query<T, Container>::FilterFunctionString * getter, QueryCmp cmp, const std::vector<std::string> & patterns) {
+    filter([getter, matcher = StringMatcher(cmp, patterns)](const T & obj) { return matcher.match(getter(obj)); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(
-    Query<T>::FilterFunctionVectorString * getter, QueryCmp cmp, const std::vector<std::string> & patterns) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto values = getter(*it);
-        if (match_string(values, cmp, patterns)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    Query<T, Container>::FilterFunctionVectorString * getter,
+    QueryCmp cmp,
+    const std::vector<std::string> & patterns) {
+    filter([getter, matcher = StringMatcher(cmp, patterns)](const T & obj) { return matcher.match(getter(obj)); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(FilterFunctionInt64 * getter, QueryCmp cmp, int64_t pattern) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (match_int64(value, cmp, pattern)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(FilterFunctionInt64 * getter, QueryCmp cmp, int64_t pattern) {
+    check_int64_cmp(cmp);
+    filter([getter, cmp, pattern](const T & obj) { return match_int64(getter(obj), cmp, pattern); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(FilterFunctionVectorInt64 * getter, QueryCmp cmp, int64_t pattern) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto values = getter(*it);
-        if (match_int64(values, cmp, pattern)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(FilterFunctionVectorInt64 * getter, QueryCmp cmp, int64_t pattern) {
+    check_int64_cmp(cmp);
+    filter([getter, cmp, pattern](const T & obj) { return match_int64(getter(obj), cmp, pattern); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(FilterFunctionInt64 * getter, QueryCmp cmp, const std::vector<int64_t> & patterns) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (match_int64(value, cmp, patterns)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    FilterFunctionInt64 * getter, QueryCmp cmp, const std::vector<int64_t> & patterns) {
+    check_int64_cmp(cmp);
+    filter([getter, cmp, patterns](const T & obj) { return match_int64(getter(obj), cmp, patterns); });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(FilterFunctionVectorInt64 * getter, QueryCmp cmp, const std::vector<int64_t> & patterns) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto values = getter(*it);
-        if (match_int64(values, cmp, patterns)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    FilterFunctionVectorInt64 * getter, QueryCmp cmp, const std::vector<int64_t> & patterns) {
+    check_int64_cmp(cmp);
+    filter([getter, cmp, patterns](const T & obj) { return match_int64(getter(obj), cmp, patterns); });
 }
 
 // TODO: other cmp
-template <typename T>
-inline void Query<T>::ifilter(Query<T>::FilterFunctionBool * getter, QueryCmp cmp, bool pattern) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (cmp == QueryCmp::EQ && value == pattern) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(Query<T, Container>::FilterFunctionBool * getter, QueryCmp cmp, bool pattern) {
+    filter([getter, cmp, pattern](const T & obj) { return cmp == QueryCmp::EQ && getter(obj) == pattern; });
 }
 
-template <typename T>
-inline void Query<T>::ifilter(Query<T>::FilterFunctionCString * getter, QueryCmp cmp, const std::string & pattern) {
-    for (auto it = get_data().begin(); it != get_data().end();) {
-        auto value = getter(*it);
-        if (match_string(value, cmp, pattern)) {
-            ++it;
-        } else {
-            it = get_data().erase(it);
-        }
-    }
+template <typename T, typename Container>
+inline void Query<T, Container>::ifilter(
+    Query<T, Container>::FilterFunctionCString * getter, QueryCmp cmp, const std::string & pattern) {
+    filter([getter, matcher = StringMatcher(cmp, pattern)](const T & obj) { return matcher.match(getter(obj)); });
 }
 
 
@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/utils/set.hpp"
 #include "libdnf/utils/weak_ptr.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -68,21 +69,28 @@ private:
 
 template <typename T, typename QueryT>
 QueryT Sack<T, QueryT>::new_query() {
-    QueryT result;
+    // items are collected first and added to the query at once, the query may be backed by a sorted vector
+    std::vector<DataItemWeakPtr> items;
 
     if (this->get_use_includes()) {
         // if includes are used, add only includes to the query
-        result = QueryT(includes);
+        items.assign(includes.get_data().begin(), includes.get_data().end());
     } else {
         // else add all items
+        items.reserve(data.size());
         for (auto & it : this->get_data()) {
-            result.add(DataItemWeakPtr(it.get(), &data_guard));
+            items.emplace_back(it.get(), &data_guard);
         }
     }
 
     // apply excludes
-    result -= excludes;
+    if (!excludes.empty()) {
+        auto is_excluded = [this](const DataItemWeakPtr & item) { return excludes.contains(item); };
+        items.erase(std::remove_if(items.begin(), items.end(), is_excluded), items.end());
+    }
 
+    QueryT result;
+    result.add(items.begin(), items.end());
     return result;
 }
 
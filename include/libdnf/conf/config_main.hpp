@@ -55,6 +55,18 @@ public:
     OptionString & system_cachedir();
     OptionBool & cacheonly();
     OptionBool & keepcache();
+    /// Compression of the solv cache files written to the cachedir: "none" or "zstd". The zstd compressed files
+    /// are smaller, but they are decompressed to memory when loaded. The format is detected when loading.
+    OptionEnum<std::string> & solv_cache_compression();
+    /// Maximal size of the cachedir (e.g. "10G"), 0 means unlimited. When it is exceeded, the least recently used
+    /// cache files not needed by the enabled repositories (packages, caches of other repositories) are removed.
+    OptionNumber<std::uint64_t> & cache_size_limit();
+    /// Cache files not needed by the enabled repositories and not used for the given time are removed,
+    /// -1 ("never") disables the removal by age.
+    OptionSeconds & cache_max_age();
+    /// The cachedir is checked for the size limit and the age at most once per the given time,
+    /// -1 ("never") disables the periodic check, the cache garbage is then collected only on request.
+    OptionSeconds & cache_gc_interval();
     OptionString & logdir();
     OptionNumber<std::int32_t> & log_size();
     OptionNumber<std::int32_t> & log_rotate();
@@ -32,6 +32,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 namespace libdnf::rpm {
 
 
+class PackageSet;
 class PackageSetIterator;
 
 
@@ -284,6 +285,7 @@ protected:
     const char * get_evr_cstring() const noexcept;
 
 private:
+    friend PackageSet;
     friend PackageSetIterator;
     SolvSackWeakPtr sack;
     PackageId id;
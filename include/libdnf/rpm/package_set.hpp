@@ -26,6 +26,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "package_set_iterator.hpp"
 #include "solv_sack.hpp"
 
+#include <functional>
 #include <memory>
 
 
@@ -45,6 +46,13 @@ class Transaction;
 /// @replaces libdnf:sack/packageset.hpp:struct:PackageSet
 class PackageSet {
 public:
+    /// Order in which `iterate_sorted()` visits the packages.
+    enum class SortOrder {
+        /// By name, then by epoch, version and release (rpm version comparison), then by architecture.
+        /// Packages with the same NEVRA (e.g. the same package from different repositories) are ordered by id.
+        NEVRA
+    };
+
     /// @replaces libdnf:hy-packageset.h:function:dnf_packageset_new(DnfSack * sack)
     explicit PackageSet(SolvSack * sack);
 
@@ -91,6 +99,10 @@ public:
     /// @replaces libdnf:hy-packageset.h:function:dnf_packageset_count(DnfPackageSet * pset)
     size_t size() const;
 
+    /// Call `callback` for every package in the set in the given order.
+    /// The packages are visited without sorting the set, the order is taken from an index cached in the SolvSack.
+    void iterate_sorted(SortOrder order, const std::function<void(Package)> & callback) const;
+
 private:
     friend PackageSetIterator;
     friend SolvQuery;
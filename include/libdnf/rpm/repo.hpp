@@ -345,6 +345,7 @@ public:
 
 private:
     class Impl;
+    friend class CacheManager;
     friend class SolvSack;
     friend struct PackageTarget;
     std::unique_ptr<Impl> p_impl;
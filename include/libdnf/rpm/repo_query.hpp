@@ -24,16 +24,22 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/rpm/repo.hpp"
 #include "libdnf/utils/weak_ptr.hpp"
 
+#include <vector>
+
 namespace libdnf::rpm {
 
+class RepoSack;
+
 /// Weak pointer to rpm repository. RepoWeakPtr does not own the repository (ptr_owner = false).
 /// Repositories are owned by RepoSack.
 using RepoWeakPtr = WeakPtr<Repo, false>;
 
-class RepoQuery : public libdnf::sack::Query<RepoWeakPtr> {
+/// Query over repositories. The repositories are held in a sorted vector, chained filters only compact it.
+/// Queries created by RepoSack look up EQ and IEXACT id patterns in the sack's id index instead of scanning.
+class RepoQuery : public libdnf::sack::Query<RepoWeakPtr, std::vector<RepoWeakPtr>> {
 public:
 #ifndef SWIG
-    using Query<RepoWeakPtr>::Query;
+    using Query<RepoWeakPtr, std::vector<RepoWeakPtr>>::Query;
 #endif
     RepoQuery & ifilter_enabled(bool enabled);
     RepoQuery & ifilter_expired(bool expired);
@@ -44,6 +50,11 @@ public:
     RepoQuery & ifilter_name(sack::QueryCmp cmp, const std::vector<std::string> & patterns);
 
 private:
+    friend RepoSack;
+
+    /// Keeps only the repositories with an id equal to any of the `patterns`, the ids are looked up in the sack.
+    void filter_id_indexed(bool icase, const std::vector<std::string> & patterns);
+
     struct F {
         static bool enabled(const RepoWeakPtr & obj) { return obj->is_enabled(); }
         static bool expired(const RepoWeakPtr & obj) { return obj->is_expired(); }
@@ -51,6 +62,8 @@ private:
         static std::string id(const RepoWeakPtr & obj) { return obj->get_id(); }
         static std::string name(const RepoWeakPtr & obj) { return obj->get_config()->name().get_value(); }
     };
+
+    RepoSack * sack{nullptr};  // sack the query was created from, nullptr if unknown
 };
 
 inline RepoQuery & RepoQuery::ifilter_enabled(bool enabled) {
@@ -63,16 +76,6 @@ inline RepoQuery & RepoQuery::ifilter_expired(bool expired) {
     return *this;
 }
 
-inline RepoQuery & RepoQuery::ifilter_id(sack::QueryCmp cmp, const std::string & pattern) {
-    ifilter(F::id, cmp, pattern);
-    return *this;
-}
-
-inline RepoQuery & RepoQuery::ifilter_id(sack::QueryCmp cmp, const std::vector<std::string> & patterns) {
-    ifilter(F::id, cmp, patterns);
-    return *this;
-}
-
 inline RepoQuery & RepoQuery::ifilter_local(bool local) {
     ifilter(F::local, sack::QueryCmp::EQ, local);
     return *this;
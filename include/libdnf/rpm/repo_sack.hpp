@@ -26,6 +26,13 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/common/sack/sack.hpp"
 #include "libdnf/logger/logger.hpp"
 
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace libdnf {
 
 class Base;
@@ -34,6 +41,13 @@ class Base;
 
 namespace libdnf::rpm {
 
+/// Result of loading of one repository by RepoSack::load_all()
+struct RepoLoadResult {
+    RepoWeakPtr repo;
+    /// The exception thrown by Repo::load(), nullptr if the repository was loaded successfully
+    std::exception_ptr error;
+};
+
 class RepoSack : public sack::Sack<Repo, RepoQuery> {
 public:
     explicit RepoSack(Base & base) : base(&base) {}
@@ -41,6 +55,10 @@ public:
     /// Creates new repository and add it into RepoSack
     RepoWeakPtr new_repo(const std::string & id);
 
+    /// Creates new query on the repositories. Its EQ and IEXACT id filters are resolved using the index
+    /// of the repository ids maintained by RepoSack.
+    RepoQuery new_query();
+
     /// Creates new repositories according to the configuration in the file defined by path.
     /// The created repositories are added into RepoSack.
     void new_repos_from_file(const std::string & path);
@@ -59,6 +77,25 @@ public:
     /// The files in the directories are read in alphabetical order.
     void new_repos_from_dirs();
 
+    /// Removes cache files not needed by the enabled repositories from the cachedir according to the
+    /// "cache_size_limit" and "cache_max_age" options. It is meant to be called after the repositories are
+    /// successfully loaded. The cachedir is scanned at most once per "cache_gc_interval" unless `force` is set.
+    /// Returns the number of freed bytes.
+    std::uint64_t collect_cache_garbage(bool force = false);
+
+    /// Loads (downloads or refreshes) metadata of the repositories in `repos` by `Repo::load()` concurrently,
+    /// at most `parallelism` repositories at once (0 means 1). The errors do not stop loading of the other
+    /// repositories, they are returned in the results. The results are sorted by the repository id, their order
+    /// does not depend on the order in which the repositories finished. The callbacks of the repositories are
+    /// called from the loading threads.
+    /// `on_result` is called from the calling thread for each result in the same order, as soon as the repository
+    /// and all the preceding ones are loaded. It can be used to report the progress. If it throws, no other
+    /// repository is started, the running loads are finished and the exception is propagated.
+    std::vector<RepoLoadResult> load_all(
+        const RepoQuery & repos,
+        std::size_t parallelism,
+        const std::function<void(const RepoLoadResult &)> & on_result = nullptr);
+
 private:
     //TODO(jrohel): Make public?
     /// Creates new repositories according to the configuration in the files with ".repo" extension in the directory
@@ -67,7 +104,15 @@ private:
     /// The files in the directory are read in alphabetical order.
     void new_repos_from_dir(const std::string & dir_path);
 
+    friend RepoQuery;
+
+    /// Adds the repositories with the given id to `result`, the case is ignored if `icase` is true.
+    void find_repos_by_id(const std::string & id, bool icase, std::vector<RepoWeakPtr> & result) const;
+
     Base * base;
+
+    // Repositories indexed by the lowercase id. The index is case-insensitive so that it serves IEXACT filters too.
+    std::unordered_multimap<std::string, RepoWeakPtr> id_index;
 };
 
 }  // namespace libdnf::rpm
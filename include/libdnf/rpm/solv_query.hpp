@@ -27,6 +27,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/common/sack/query_cmp.hpp"
 #include "libdnf/utils/exception.hpp"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -54,6 +55,22 @@ public:
         const char * get_description() const noexcept override { return "Query exception"; }
     };
 
+    /// Statistics of one filter call recorded when profiling of the query is enabled, see `set_profiling()`.
+    struct FilterStats {
+        /// Name of the filter method, e.g. "ifilter_name"
+        const char * filter_name{nullptr};
+        libdnf::sack::QueryCmp cmp_type{libdnf::sack::QueryCmp::EQ};
+        /// Number of packages in the query before the filter was applied
+        std::size_t input_size{0};
+        /// Number of packages in the query after the filter was applied
+        std::size_t output_size{0};
+        /// Wall time spent in the filter
+        std::chrono::nanoseconds duration{0};
+        /// True when the filter looked the matching packages up in an index (sorted solvables, provides),
+        /// false when it had to test each candidate package
+        bool indexed{false};
+    };
+
     /// @replaces libdnf/hy-query.h:function:hy_query_create(DnfSack *sack);
     /// @replaces libdnf/hy-query.h:function:hy_query_create_flags(DnfSack *sack, int flags);
     /// @replaces libdnf/sack/query.hpp:method:Query(DnfSack* sack, ExcludeFlags flags = ExcludeFlags::APPLY_EXCLUDES)
@@ -298,6 +315,26 @@ public:
     /// @replaces libdnf/sack/query.hpp:method:Query.size()
     std::size_t size() const noexcept;
 
+    /// Set the number of threads used by the filters that have to inspect data of each candidate package:
+    /// ifilter_file(), ifilter_description(), ifilter_summary(), ifilter_url() and the dependency filters
+    /// (ifilter_requires(), ifilter_conflicts(), ...). The candidates are split into partitions aligned
+    /// to the words of the query bitmap and each partition is evaluated by a separate thread.
+    /// The default value 1 evaluates all filters in the calling thread. The value is clamped to the range from 1
+    /// to the number of concurrent threads supported by the hardware. The threads are started by the first
+    /// parallel filter and reused by the following filters of all queries of the SolvSack. The data searched by
+    /// the parallel ifilter_file(), ifilter_description(), ifilter_summary() and ifilter_url() are read into memory
+    /// instead of being paged from the solv cache files, they stay there until the repository is unloaded.
+    void set_num_workers(unsigned int num_workers) noexcept;
+
+    /// Enable or disable recording of `FilterStats` for the subsequent filter calls. Disabled by default.
+    /// The statistics of each recorded filter are also written to the debug log.
+    /// A disabled profiling does not allocate nor read the clock, it only tests a flag.
+    void set_profiling(bool enable) noexcept;
+
+    /// Return statistics of the filters applied while the profiling was enabled, in the order of the calls.
+    /// When a filter calls another filter, only the outer call is recorded.
+    const std::vector<FilterStats> & explain() const noexcept;
+
     // TODO(jmracek) return std::pair<bool, std::unique_ptr<libdnf::rpm::Nevra>>
     /// @replaces libdnf/sack/query.hpp:method:std::pair<bool, std::unique_ptr<Nevra>> filterSubject(const char * subject, HyForm * forms, bool icase, bool with_nevra, bool with_provides, bool with_filenames);
     std::pair<bool, libdnf::rpm::Nevra> resolve_pkg_spec(
@@ -24,7 +24,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/utils/exception.hpp"
 #include "libdnf/utils/weak_ptr.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace libdnf {
 
@@ -84,6 +87,68 @@ class SolvSack;
 
 using SolvSackWeakPtr = WeakPtr<SolvSack, false>;
 
+/// Memory (in bytes) used by the data of a repository loaded in the SolvSack
+struct RepoMemoryUsage {
+    std::string repo_id;
+    std::size_t solvables{0};       // solvables (packages, advisories) of the repository
+    std::size_t dependencies{0};    // arrays of dependencies (provides, requires, ...) of the solvables
+    std::size_t strings{0};         // local string pools of the extensions, the other strings are in the global pool
+    std::size_t main_repodata{0};   // incore data of the main (primary) metadata
+    std::size_t filelists{0};       // incore data of the filelists extension
+    std::size_t other{0};           // incore data of the other (changelogs) extension
+    std::size_t presto{0};          // incore data of the presto (deltas) extension
+    std::size_t updateinfo{0};      // incore data of the updateinfo
+    std::size_t whatprovides{0};    // entries of the provides index pointing to the solvables of the repository
+    std::size_t libdnf_indexes{0};  // entries of the libdnf caches for the solvables of the repository
+
+    std::size_t get_total() const noexcept {
+        return solvables + dependencies + strings + main_repodata + filelists + other + presto + updateinfo +
+               whatprovides + libdnf_indexes;
+    }
+};
+
+/// Memory (in bytes) used by the SolvSack, see SolvSack::get_memory_usage()
+/// The strings and relations are deduplicated across the repositories, they are not attributed to a repository.
+struct SolvSackMemoryUsage {
+    std::vector<RepoMemoryUsage> repos;
+    std::size_t string_pool{0};     // global string pool shared by all repositories
+    std::size_t relations{0};       // relational dependencies (e.g. "name >= version") shared by all repositories
+    std::size_t whatprovides{0};    // shared part of the provides index (offsets by string and relation ids, ...)
+    std::size_t libdnf_indexes{0};  // shared part of the libdnf caches (evr strings, unused capacity, ...)
+
+    std::size_t get_total() const noexcept {
+        std::size_t total = string_pool + relations + whatprovides + libdnf_indexes;
+        for (const auto & repo : repos) {
+            total += repo.get_total();
+        }
+        return total;
+    }
+};
+
+/// Main data (packages with their dependencies and added file provides) of available repositories shared by
+/// the SolvSacks of several Bases, e.g. of Bases with the same repositories and different installroots.
+/// A SolvSack with the cache set by `SolvSack::set_shared_repo_cache()` loads a repository from the cache
+/// if it was stored for the same metadata, the solv cache files and the metadata are not read. Otherwise the
+/// repository is loaded as usual and stored into the cache. Each SolvSack keeps its own system repository,
+/// excludes and extensions. The data are kept in anonymous memory files, the paged data (descriptions, ...)
+/// are read from the same memory by all SolvSacks. The cache can be used by SolvSacks in several threads.
+class SharedRepoCache {
+public:
+    SharedRepoCache();
+    ~SharedRepoCache();
+
+    /// Removes all stored repositories. The data of the repositories loaded from the cache stay valid.
+    void clear();
+
+    /// Returns number of the stored repositories
+    std::size_t size() const;
+
+private:
+    friend SolvSack;
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
 class SolvSack {
 public:
     class Exception : public RuntimeError {
@@ -125,9 +190,64 @@ public:
     /// Loads rpm::Repo into SolvSack.
     void load_repo(Repo & repo, LoadRepoFlags flags);
 
+    /// Writes missing or outdated solv cache files of the rpm::Repo (main data and the updateinfo if selected
+    /// by `flags`). A following `load_repo()` then only reads the cache files instead of parsing the metadata.
+    /// The extensions loaded on demand (filelists, other, presto) are not parsed, their caches are written
+    /// on their first use.
+    /// The metadata are parsed into a private libsolv pool and the SolvSack is not modified. The method can be
+    /// called for several repositories from several threads at once, also while another repository is being loaded
+    /// by `load_repo()`. It does nothing if the "build_cache" option of the repository is disabled.
+    void build_repo_cache(Repo & repo, LoadRepoFlags flags);
+
+    /// Sets the cache of available repositories shared with other SolvSacks, see SharedRepoCache.
+    /// It is used by the following `load_repo()` calls, `nullptr` stops the sharing.
+    void set_shared_repo_cache(std::shared_ptr<SharedRepoCache> cache);
+
+    /// Removes the repository and all its data from the SolvSack. Its packages disappear from the SolvSack
+    /// and all existing package sets and queries of the SolvSack are invalidated (see `get_weak_ptr()`).
+    /// The repository can be loaded again by `load_repo()`, e.g. after its metadata were refreshed.
+    /// The Repo object of the system repository is destroyed, `create_system_repo()` can be called again.
+    void unload_repo(Repo & repo);
+
+    /// Frees the extensions (loaded or registered for loading on demand) of the repository selected by `flags`.
+    /// The packages, package sets and queries are not affected, only the data of the extensions are not available
+    /// anymore. Updateinfo cannot be dropped because it adds packages (advisories), the repository has to be
+    /// unloaded instead.
+    void drop_repo_extensions(Repo & repo, LoadRepoFlags flags);
+
+    /// Creates a copy of the SolvSack for what-if evaluations, the copy can be modified (e.g. repositories removed
+    /// by `unload_repo()`, the system repository replaced) and thrown away without touching this SolvSack.
+    /// The copy has its own system repository. It contains the main data (packages with dependencies and added
+    /// file provides) of all repositories, the extensions (file lists, advisories, ...) are not copied.
+    /// The packages of the copied available repositories are not bound to the Repo objects, `Package::get_repo()`
+    /// returns nullptr for them. The data are copied through anonymous memory files that are reused by the following
+    /// forks until the SolvSack changes, the paged data are shared.
+    std::unique_ptr<SolvSack> fork();
+
     /// Creates system repository and loads it into SolvSack. Only one system repository can be in SolvSack.
+    /// With `build_cache` the rpmdb is cached in the "@System.solv" file in the cachedir. The cache is reused
+    /// until the rpmdb changes, an outdated cache speeds up the following read of the rpmdb.
     void create_system_repo(bool build_cache = false);
 
+    /// Writes snapshot of all repositories loaded in the SolvSack into the `path` file. The snapshot contains
+    /// the main data of the repositories including the added file provides, and the sorted index of packages.
+    /// It is keyed by checksums of the metadata (rpmdb for the system repository), the repository ids and
+    /// the load flags. Only available and system repositories can be stored.
+    void write_snapshot(const std::string & path);
+
+    /// Loads the system repository (if `with_system_repo` is set) and the `repos` in the given order from
+    /// the snapshot written by `write_snapshot()`. The extensions selected by `flags` are loaded as by `load_repo()`.
+    /// The SolvSack must be empty. Returns `false` and loads nothing if the snapshot does not exist, or it was
+    /// written for other repositories, load flags or metadata.
+    bool load_snapshot(
+        const std::string & path, const std::vector<Repo *> & repos, LoadRepoFlags flags, bool with_system_repo);
+
+    /// Returns memory used by the loaded data per repository and data type. The sizes are computed from
+    /// the libsolv structures, the data (e.g. extensions) are not loaded. The paged data of the solv cache files
+    /// are not counted, they are read through the page cache. The entries of the provides index and of the libdnf
+    /// caches are attributed to the repositories of their packages, the rest of the indexes is reported as shared.
+    SolvSackMemoryUsage get_memory_usage() const;
+
     // TODO (lhrazky): There's an overlap with dumping the debugdata on the Goal class
     void dump_debugdata(const std::string & dir);
 
@@ -21,148 +21,346 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF_UTILS_SET_HPP
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <set>
+#include <type_traits>
+#include <vector>
 
 namespace libdnf {
 
 /// Set represents set of objects (e.g. repositories, or groups)
 /// and implements set operations such as unions or differences.
-template <typename T>
+///
+/// The objects are kept ordered by `operator<` in a `Container`, which is either `std::set<T>` (default)
+/// or `std::vector<T>`. The vector is kept sorted and without duplicates. It stores the objects contiguously
+/// and the set operations are linear merges without per-object allocations. Adding or removing a single object
+/// moves the following objects, so the vector suits sets that are built at once and then combined.
+///
+/// Derived classes (Query) can defer filtering. The deferred predicates are applied together in a single pass
+/// over the objects the next time the set is accessed. Const access can therefore modify the set, a set with
+/// deferred filters must not be read from multiple threads at once.
+template <typename T, typename Container = std::set<T>>
 class Set {
+    static_assert(
+        std::is_same_v<Container, std::set<T>> || std::is_same_v<Container, std::vector<T>>,
+        "Set container must be std::set<T> or std::vector<T>");
+
 public:
     Set() = default;
-    Set(const Set<T> & other) : data(other.data) {}
-    Set(Set<T> && other) : data(std::move(other.data)) {}
-    Set(std::initializer_list<T> ilist) : data(ilist) {}
+    Set(const Set<T, Container> & other) {
+        other.apply_pending_filters();
+        data = other.data;
+    }
+    Set(Set<T, Container> && other)
+        : data(std::move(other.data)),
+          pending_filters(std::move(other.pending_filters)) {}
+    Set(std::initializer_list<T> ilist) : data(ilist) { normalize(); }
     ~Set() = default;
 
     // GENERIC OPERATIONS
-    bool empty() const noexcept { return data.empty(); };
-    std::size_t size() const noexcept { return data.size(); }
-    void clear() noexcept { data.clear(); }
+    bool empty() const {
+        apply_pending_filters();
+        return data.empty();
+    };
+    std::size_t size() const {
+        apply_pending_filters();
+        return data.size();
+    }
+    void clear() noexcept {
+        data.clear();
+        pending_filters.clear();
+    }
 
     // ITEM OPERATIONS
-    void add(const T & obj) { data.insert(obj); }
-    void add(T && obj) { data.insert(std::move(obj)); }
-    void remove(const T & obj) { data.erase(obj); }
-    bool contains(const T & obj) const { return data.find(obj) != data.end(); }
+    void add(const T & obj);
+    void add(T && obj);
+    /// Add objects from the range at once, the sorted vector is sorted only once
+    template <typename InputIt>
+    void add(InputIt first, InputIt last);
+    void remove(const T & obj);
+    bool contains(const T & obj) const;
 
     // SET OPERATIONS
-    Set<T> & operator=(const Set<T> & other);
-    Set<T> & operator=(Set<T> && other) noexcept;
-    Set<T> & operator=(std::initializer_list<T> ilist);
-    Set<T> & operator|=(const Set<T> & other);
-    Set<T> & operator&=(const Set<T> & other);
-    Set<T> & operator-=(const Set<T> & other);
-    Set<T> & operator^=(const Set<T> & other);
+    Set<T, Container> & operator=(const Set<T, Container> & other);
+    Set<T, Container> & operator=(Set<T, Container> && other) noexcept;
+    Set<T, Container> & operator=(std::initializer_list<T> ilist);
+    Set<T, Container> & operator|=(const Set<T, Container> & other);
+    Set<T, Container> & operator&=(const Set<T, Container> & other);
+    Set<T, Container> & operator-=(const Set<T, Container> & other);
+    Set<T, Container> & operator^=(const Set<T, Container> & other);
 
     // update == union
-    void update(const Set<T> & other) { *this |= other; }
-    void intersection(const Set<T> & other) { *this &= other; }
-    void difference(const Set<T> & other) { *this -= other; }
-    void symmetric_difference(const Set<T> & other) { *this ^= other; }
-    bool is_subset(const Set<T> & other) const;
-    bool is_superset(const Set<T> & other) const;
+    void update(const Set<T, Container> & other) { *this |= other; }
+    void intersection(const Set<T, Container> & other) { *this &= other; }
+    void difference(const Set<T, Container> & other) { *this -= other; }
+    void symmetric_difference(const Set<T, Container> & other) { *this ^= other; }
+    bool is_subset(const Set<T, Container> & other) const;
+    bool is_superset(const Set<T, Container> & other) const;
 
-    void swap(Set<T> & other) noexcept { data.swap(other.data); }
+    void swap(Set<T, Container> & other) noexcept {
+        data.swap(other.data);
+        pending_filters.swap(other.pending_filters);
+    }
 
     // TODO(jrohel): Temporary solution. Implement iterator and other stuff and then remove this hack.
-    /// Return reference to underlying std::set
-    const std::set<T> & get_data() const noexcept { return data; }
-    std::set<T> & get_data() noexcept { return data; }
+    /// Return reference to underlying container
+    const Container & get_data() const {
+        apply_pending_filters();
+        return data;
+    }
+    Container & get_data() {
+        apply_pending_filters();
+        return data;
+    }
+
+protected:
+    using Predicate = std::function<bool(const T & obj)>;
+
+    /// Defers keeping only the objects for which `match` returns true until the set is accessed.
+    /// All deferred predicates are then evaluated in a single pass, the object is dropped on the first mismatch.
+    void add_pending_filter(Predicate match) { pending_filters.push_back(std::move(match)); }
 
 private:
-    friend bool operator==(const Set<T> & lhs, const Set<T> & rhs) { return lhs.data == rhs.data; }
+    static constexpr bool is_sorted_vector = std::is_same_v<Container, std::vector<T>>;
+
+    friend bool operator==(const Set<T, Container> & lhs, const Set<T, Container> & rhs) {
+        lhs.apply_pending_filters();
+        rhs.apply_pending_filters();
+        return lhs.data == rhs.data;
+    }
+
+    /// Applies the deferred filters. The kept objects are collected into a new container, which replaces the data
+    /// only when all filters succeeded. If a filter throws, the data and the deferred filters stay unchanged.
+    void apply_pending_filters() const;
 
-    // TODO(jrohel): Performance? May be changed to std::unordered_set in future. Or container as template parameter.
-    std::set<T> data;
+    /// Sorts the vector and removes duplicates, does nothing for std::set
+    void normalize();
+
+    /// Replaces the data with the output of the `merge` algorithm (std::set_union, ...) applied to both sets.
+    /// `reserve` is the size to reserve in the vector for the result.
+    template <typename Merge>
+    void merge_with(const Set<T, Container> & other, std::size_t reserve, Merge merge);
+
+    // mutable: the deferred filters are applied on const access too
+    mutable Container data;
+    mutable std::vector<Predicate> pending_filters;
 };
 
+/// Set backed by a sorted vector
 template <typename T>
-inline Set<T> & Set<T>::operator=(const Set<T> & other) {
+using SortedVectorSet = Set<T, std::vector<T>>;
+
+template <typename T, typename Container>
+inline void Set<T, Container>::normalize() {
+    if constexpr (is_sorted_vector) {
+        std::sort(data.begin(), data.end());
+        data.erase(std::unique(data.begin(), data.end()), data.end());
+    }
+}
+
+template <typename T, typename Container>
+inline void Set<T, Container>::apply_pending_filters() const {
+    if (pending_filters.empty()) {
+        return;
+    }
+    auto match = [this](const T & obj) {
+        for (auto & filter : pending_filters) {
+            if (!filter(obj)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // the kept objects are appended in the order of the data, the vector stays sorted
+    Container kept;
+    for (const auto & obj : data) {
+        if (match(obj)) {
+            kept.insert(kept.end(), obj);
+        }
+    }
+    data.swap(kept);
+    pending_filters.clear();
+}
+
+template <typename T, typename Container>
+template <typename Merge>
+inline void Set<T, Container>::merge_with(const Set<T, Container> & other, std::size_t reserve, Merge merge) {
+    apply_pending_filters();
+    other.apply_pending_filters();
+    Container result;
+    if constexpr (is_sorted_vector) {
+        result.reserve(reserve);
+        merge(data.begin(), data.end(), other.data.begin(), other.data.end(), std::back_inserter(result));
+    } else {
+        // the merged objects come in order, the hint at the end makes each insertion amortized constant
+        merge(data.begin(), data.end(), other.data.begin(), other.data.end(), std::inserter(result, result.end()));
+    }
+    data = std::move(result);
+}
+
+template <typename T, typename Container>
+inline void Set<T, Container>::add(const T & obj) {
+    apply_pending_filters();
+    if constexpr (is_sorted_vector) {
+        auto it = std::lower_bound(data.begin(), data.end(), obj);
+        if (it == data.end() || obj < *it) {
+            data.insert(it, obj);
+        }
+    } else {
+        data.insert(obj);
+    }
+}
+
+template <typename T, typename Container>
+inline void Set<T, Container>::add(T && obj) {
+    apply_pending_filters();
+    if constexpr (is_sorted_vector) {
+        auto it = std::lower_bound(data.begin(), data.end(), obj);
+        if (it == data.end() || obj < *it) {
+            data.insert(it, std::move(obj));
+        }
+    } else {
+        data.insert(std::move(obj));
+    }
+}
+
+template <typename T, typename Container>
+template <typename InputIt>
+inline void Set<T, Container>::add(InputIt first, InputIt last) {
+    apply_pending_filters();
+    if constexpr (is_sorted_vector) {
+        auto old_size = static_cast<std::ptrdiff_t>(data.size());
+        data.insert(data.end(), first, last);
+        std::sort(data.begin() + old_size, data.end());
+        std::inplace_merge(data.begin(), data.begin() + old_size, data.end());
+        data.erase(std::unique(data.begin(), data.end()), data.end());
+    } else {
+        data.insert(first, last);
+    }
+}
+
+template <typename T, typename Container>
+inline void Set<T, Container>::remove(const T & obj) {
+    apply_pending_filters();
+    if constexpr (is_sorted_vector) {
+        auto it = std::lower_bound(data.begin(), data.end(), obj);
+        if (it != data.end() && !(obj < *it)) {
+            data.erase(it);
+        }
+    } else {
+        data.erase(obj);
+    }
+}
+
+template <typename T, typename Container>
+inline bool Set<T, Container>::contains(const T & obj) const {
+    apply_pending_filters();
+    if constexpr (is_sorted_vector) {
+        return std::binary_search(data.begin(), data.end(), obj);
+    } else {
+        return data.find(obj) != data.end();
+    }
+}
+
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator=(const Set<T, Container> & other) {
+    other.apply_pending_filters();
     data = other.data;
+    pending_filters.clear();
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator=(Set<T> && other) noexcept {
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator=(Set<T, Container> && other) noexcept {
     data = std::move(other.data);
+    pending_filters = std::move(other.pending_filters);
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator=(std::initializer_list<T> ilist) {
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator=(std::initializer_list<T> ilist) {
     data = ilist;
+    pending_filters.clear();
+    normalize();
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator|=(const Set<T> & other) {
-    std::set<T> result;
-    std::set_union(
-        data.begin(), data.end(), other.data.begin(), other.data.end(), std::inserter(result, result.begin()));
-    data = result;
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator|=(const Set<T, Container> & other) {
+    merge_with(other, size() + other.size(), [](auto first1, auto last1, auto first2, auto last2, auto out) {
+        std::set_union(first1, last1, first2, last2, out);
+    });
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator&=(const Set<T> & other) {
-    std::set<T> result;
-    std::set_intersection(
-        data.begin(), data.end(), other.data.begin(), other.data.end(), std::inserter(result, result.begin()));
-    data = std::move(result);
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator&=(const Set<T, Container> & other) {
+    auto max_result_size = std::min(size(), other.size());
+    merge_with(other, max_result_size, [](auto first1, auto last1, auto first2, auto last2, auto out) {
+        std::set_intersection(first1, last1, first2, last2, out);
+    });
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator-=(const Set<T> & other) {
-    std::set<T> result;
-    std::set_difference(
-        data.begin(), data.end(), other.data.begin(), other.data.end(), std::inserter(result, result.begin()));
-    data = result;
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator-=(const Set<T, Container> & other) {
+    merge_with(other, size(), [](auto first1, auto last1, auto first2, auto last2, auto out) {
+        std::set_difference(first1, last1, first2, last2, out);
+    });
     return *this;
 }
 
-template <typename T>
-inline Set<T> & Set<T>::operator^=(const Set<T> & other) {
-    std::set<T> result;
-    std::set_symmetric_difference(
-        data.begin(), data.end(), other.data.begin(), other.data.end(), std::inserter(result, result.begin()));
-    data = result;
+template <typename T, typename Container>
+inline Set<T, Container> & Set<T, Container>::operator^=(const Set<T, Container> & other) {
+    merge_with(other, size() + other.size(), [](auto first1, auto last1, auto first2, auto last2, auto out) {
+        std::set_symmetric_difference(first1, last1, first2, last2, out);
+    });
     return *this;
 }
 
-template <typename T>
-inline bool Set<T>::is_subset(const Set<T> & other) const {
+template <typename T, typename Container>
+inline bool Set<T, Container>::is_subset(const Set<T, Container> & other) const {
+    apply_pending_filters();
+    other.apply_pending_filters();
     return std::includes(other.data.begin(), other.data.end(), data.begin(), data.end());
 }
 
-template <typename T>
-inline bool Set<T>::is_superset(const Set<T> & other) const {
+template <typename T, typename Container>
+inline bool Set<T, Container>::is_superset(const Set<T, Container> & other) const {
+    apply_pending_filters();
+    other.apply_pending_filters();
     return std::includes(data.begin(), data.end(), other.data.begin(), other.data.end());
 }
 
-template <typename T>
-inline Set<T> operator|(const Set<T> & lhs, const Set<T> & rhs) {
-    Set<T> ret(lhs);
+/// Compare sets with different containers
+template <typename T, typename Container, typename OtherContainer>
+inline bool operator==(const Set<T, Container> & lhs, const Set<T, OtherContainer> & rhs) {
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.get_data().begin(), lhs.get_data().end(), rhs.get_data().begin(), rhs.get_data().end());
+}
+
+template <typename T, typename Container>
+inline Set<T, Container> operator|(const Set<T, Container> & lhs, const Set<T, Container> & rhs) {
+    Set<T, Container> ret(lhs);
     return ret |= rhs;
 }
 
-template <typename T>
-inline Set<T> operator&(const Set<T> & lhs, const Set<T> & rhs) {
-    Set<T> ret(lhs);
+template <typename T, typename Container>
+inline Set<T, Container> operator&(const Set<T, Container> & lhs, const Set<T, Container> & rhs) {
+    Set<T, Container> ret(lhs);
     return ret &= rhs;
 }
 
-template <typename T>
-inline Set<T> operator-(const Set<T> & lhs, const Set<T> & rhs) {
-    Set<T> ret(lhs);
+template <typename T, typename Container>
+inline Set<T, Container> operator-(const Set<T, Container> & lhs, const Set<T, Container> & rhs) {
+    Set<T, Container> ret(lhs);
     return ret -= rhs;
 }
 
-template <typename T>
-inline Set<T> operator^(const Set<T> & lhs, const Set<T> & rhs) {
-    Set<T> ret(lhs);
+template <typename T, typename Container>
+inline Set<T, Container> operator^(const Set<T, Container> & lhs, const Set<T, Container> & rhs) {
+    Set<T, Container> ret(lhs);
     return ret ^= rhs;
 }
 
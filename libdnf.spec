@@ -66,6 +66,7 @@ BuildRequires:  pkgconfig(modulemd-2.0) >= %{libmodulemd_version}
 %endif
 BuildRequires:  pkgconfig(rpm) >= 4.11.0
 BuildRequires:  pkgconfig(sqlite3)
+BuildRequires:  pkgconfig(libzstd)
 %if %{with zchunk}
 BuildRequires:  pkgconfig(zck) >= %{zchunk_version}
 %endif
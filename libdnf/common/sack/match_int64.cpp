@@ -76,6 +76,12 @@ bool match_int64(int64_t value, QueryCmp cmp, int64_t pattern) {
 }
 
 
+void check_int64_cmp(QueryCmp cmp) {
+    // unsupported comparisons throw regardless of the compared values
+    match_int64(0, cmp, 0);
+}
+
+
 bool match_int64(int64_t value, QueryCmp cmp, const std::vector<int64_t> & patterns) {
     bool result = false;
     for (auto & pattern : patterns) {
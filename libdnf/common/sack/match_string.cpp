@@ -21,115 +21,181 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <fnmatch.h>
 
-#include <regex>
+#include <cctype>
+#include <cstring>
 #include <stdexcept>
 
 
 namespace libdnf::sack {
 
 
-inline std::string tolower(const std::string & s) {
-    std::string result = s;
-    std::for_each(result.begin(), result.end(), [](char & c) { c = static_cast<char>(::tolower(c)); });
-    return result;
+namespace {
+
+// Compares `len` characters of the strings ignoring the case.
+bool iequal(const char * lhs, const char * rhs, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        if (::tolower(static_cast<unsigned char>(lhs[i])) != ::tolower(static_cast<unsigned char>(rhs[i]))) {
+            return false;
+        }
+    }
+    return true;
 }
 
+// Glob pattern without any wildcard or escape matches only the identical string.
+bool is_glob(const std::string & pattern) {
+    return pattern.find_first_of("*?[(\\") != std::string::npos;
+}
 
-bool match_string(const std::string & value, QueryCmp cmp, const std::string & pattern) {
-    bool result = false;
-    switch (cmp) {
+}  // namespace
+
+
+StringMatcher::StringMatcher(QueryCmp cmp, const std::string & pattern) : StringMatcher(cmp, std::vector{pattern}) {}
+
+
+StringMatcher::StringMatcher(QueryCmp cmp, const std::vector<std::string> & patterns) : cmp(cmp) {
+    if (cmp == QueryCmp::NOT || cmp == QueryCmp::ICASE) {
+        throw std::runtime_error("Operator flag cannot be used standalone");
+    }
+    // NOT applies to any string comparison, including those without a NOT_* enumerator (e.g. NOT | STARTSWITH)
+    if ((cmp & QueryCmp::NOT) == QueryCmp::NOT) {
+        negate = true;
+        this->cmp = cmp - QueryCmp::NOT;
+    }
+    switch (this->cmp) {
         case QueryCmp::EXACT:
-            result = value == pattern;
-            break;
-        case QueryCmp::NEQ:
-            result = value != pattern;
-            break;
         case QueryCmp::IEXACT:
-            result = tolower(value) == tolower(pattern);
+        case QueryCmp::GLOB:
+        case QueryCmp::IGLOB:
+        case QueryCmp::REGEX:
+        case QueryCmp::IREGEX:
+        case QueryCmp::CONTAINS:
+        case QueryCmp::ICONTAINS:
+        case QueryCmp::STARTSWITH:
+        case QueryCmp::ISTARTSWITH:
+        case QueryCmp::ENDSWITH:
+        case QueryCmp::IENDSWITH:
             break;
+        default:
+            throw std::runtime_error("Unsupported operator");
+    }
+
+    this->patterns.reserve(patterns.size());
+    for (auto & pattern : patterns) {
+        add_pattern(pattern);
+    }
+}
+
+
+void StringMatcher::add_pattern(const std::string & pattern) {
+    auto & item = patterns.emplace_back(Pattern{cmp, pattern, {}});
+    switch (cmp) {
         case QueryCmp::GLOB:
-            result = fnmatch(pattern.c_str(), value.c_str(), FNM_EXTMATCH) == 0;
+            if (!is_glob(pattern)) {
+                item.cmp = QueryCmp::EXACT;
+            }
             break;
         case QueryCmp::IGLOB:
-            result = fnmatch(pattern.c_str(), value.c_str(), FNM_CASEFOLD | FNM_EXTMATCH) == 0;
+            if (!is_glob(pattern)) {
+                item.cmp = QueryCmp::IEXACT;
+            }
             break;
         case QueryCmp::REGEX:
-            result = std::regex_match(value, std::regex(pattern));
+            item.regex.assign(pattern, std::regex::optimize);
             break;
         case QueryCmp::IREGEX:
-            result = std::regex_match(value, std::regex(pattern, std::regex::icase));
+            item.regex.assign(pattern, std::regex::optimize | std::regex::icase);
+            break;
+        default:
             break;
+    }
+}
 
-        // TODO(jrohel): implement missing comparisons
-        case QueryCmp::NOT_GLOB:
-        case QueryCmp::NOT_IGLOB:
-        case QueryCmp::NOT_IEXACT:
+
+bool StringMatcher::match(const char * value, std::size_t value_len, const Pattern & pattern) {
+    auto & text = pattern.text;
+    switch (pattern.cmp) {
+        case QueryCmp::EXACT:
+            return value_len == text.size() && std::memcmp(value, text.data(), value_len) == 0;
+        case QueryCmp::IEXACT:
+            return value_len == text.size() && iequal(value, text.data(), value_len);
         case QueryCmp::CONTAINS:
-        case QueryCmp::NOT_CONTAINS:
+            return memmem(value, value_len, text.data(), text.size()) != nullptr;
         case QueryCmp::ICONTAINS:
-        case QueryCmp::NOT_ICONTAINS:
+            return strcasestr(value, text.c_str()) != nullptr;
         case QueryCmp::STARTSWITH:
+            return value_len >= text.size() && std::memcmp(value, text.data(), text.size()) == 0;
         case QueryCmp::ISTARTSWITH:
+            return value_len >= text.size() && iequal(value, text.data(), text.size());
         case QueryCmp::ENDSWITH:
+            return value_len >= text.size() &&
+                   std::memcmp(value + value_len - text.size(), text.data(), text.size()) == 0;
         case QueryCmp::IENDSWITH:
-            throw std::runtime_error("Not implemented yet");
-            break;
-        case QueryCmp::ISNULL:
-        case QueryCmp::LT:
-        case QueryCmp::LTE:
-        case QueryCmp::GT:
-        case QueryCmp::GTE:
-            throw std::runtime_error("Unsupported operator");
-            break;
-        case QueryCmp::NOT:
-        case QueryCmp::ICASE:
-            throw std::runtime_error("Operator flag cannot be used standalone");
-            break;
+            return value_len >= text.size() && iequal(value + value_len - text.size(), text.data(), text.size());
+        case QueryCmp::GLOB:
+            return fnmatch(text.c_str(), value, FNM_EXTMATCH) == 0;
+        case QueryCmp::IGLOB:
+            return fnmatch(text.c_str(), value, FNM_CASEFOLD | FNM_EXTMATCH) == 0;
+        case QueryCmp::REGEX:
+        case QueryCmp::IREGEX:
+            return std::regex_match(value, value + value_len, pattern.regex);
+        default:
+            // other comparisons are rejected in the constructor
+            return false;
     }
-    return result;
 }
 
 
-bool match_string(const std::string & value, QueryCmp cmp, const std::vector<std::string> & patterns) {
-    bool result = false;
+bool StringMatcher::match(const std::string & value) const {
     for (auto & pattern : patterns) {
-        if (match_string(value, cmp, pattern)) {
-            result = true;
-            break;
+        if (match(value.c_str(), value.size(), pattern) != negate) {
+            return true;
         }
     }
-    return result;
+    return false;
 }
 
 
-bool match_string(const std::vector<std::string> & values, QueryCmp cmp, const std::string & pattern) {
-    bool result = false;
+bool StringMatcher::match(const std::vector<std::string> & values) const {
     for (auto & value : values) {
-        if (match_string(value, cmp, pattern)) {
-            result = true;
-            break;
+        if (match(value)) {
+            return true;
         }
     }
-    return result;
+    return false;
 }
 
 
-bool match_string(const std::vector<std::string> & values, QueryCmp cmp, const std::vector<std::string> & patterns) {
-    bool result = false;
-    bool found = false;
-    for (auto & value : values) {
-        for (auto & pattern : patterns) {
-            if (match_string(value, cmp, pattern)) {
-                result = true;
-                found = true;
-                break;
-            }
-        }
-        if (found) {
-            break;
+bool StringMatcher::match(const char * value) const {
+    if (!value) {
+        return negate && !patterns.empty();
+    }
+    auto value_len = std::strlen(value);
+    for (auto & pattern : patterns) {
+        if (match(value, value_len, pattern) != negate) {
+            return true;
         }
     }
-    return result;
+    return false;
+}
+
+
+bool match_string(const std::string & value, QueryCmp cmp, const std::string & pattern) {
+    return StringMatcher(cmp, pattern).match(value);
+}
+
+
+bool match_string(const std::string & value, QueryCmp cmp, const std::vector<std::string> & patterns) {
+    return StringMatcher(cmp, patterns).match(value);
+}
+
+
+bool match_string(const std::vector<std::string> & values, QueryCmp cmp, const std::string & pattern) {
+    return StringMatcher(cmp, pattern).match(values);
+}
+
+
+bool match_string(const std::vector<std::string> & values, QueryCmp cmp, const std::vector<std::string> & patterns) {
+    return StringMatcher(cmp, patterns).match(values);
 }
 
 
@@ -58,8 +58,8 @@ namespace libdnf {
 /// 1k = 1024 bytes is used.
 ///
 /// @param str Bandwidth as user friendly string
-/// @return int Number of bytes
-static int str_to_bytes(const std::string & str) {
+/// @return double Number of bytes
+static double str_to_bytes_value(const std::string & str) {
     if (str.empty()) {
         throw Option::InvalidValue("no value specified");
     }
@@ -92,7 +92,16 @@ static int str_to_bytes(const std::string & str) {
         }
     }
 
-    return static_cast<int>(res);
+    return res;
+}
+
+static int str_to_bytes(const std::string & str) {
+    return static_cast<int>(str_to_bytes_value(str));
+}
+
+/// @brief Converts a friendly size option to bytes, sizes over 2 GiB are allowed
+static std::uint64_t str_to_bytes_64(const std::string & str) {
+    return static_cast<std::uint64_t>(str_to_bytes_value(str));
 }
 
 static void add_from_file(std::ostream & out, const std::string & file_path) {
@@ -191,6 +200,10 @@ class ConfigMain::Impl {
     OptionPath system_cachedir{SYSTEM_CACHEDIR};
     OptionBool cacheonly{false};
     OptionBool keepcache{false};
+    OptionEnum<std::string> solv_cache_compression{"none", {"none", "zstd"}};
+    OptionNumber<std::uint64_t> cache_size_limit{0, str_to_bytes_64};
+    OptionSeconds cache_max_age{-1};
+    OptionSeconds cache_gc_interval{60 * 60 * 24};
     OptionString logdir{"/var/log"};
     OptionNumber<std::int32_t> log_size{1024 * 1024, str_to_bytes};
     OptionNumber<std::int32_t> log_rotate{4, 0};
@@ -372,6 +385,10 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("system_cachedir", system_cachedir);
     owner.opt_binds().add("cacheonly", cacheonly);
     owner.opt_binds().add("keepcache", keepcache);
+    owner.opt_binds().add("solv_cache_compression", solv_cache_compression);
+    owner.opt_binds().add("cache_size_limit", cache_size_limit);
+    owner.opt_binds().add("cache_max_age", cache_max_age);
+    owner.opt_binds().add("cache_gc_interval", cache_gc_interval);
     owner.opt_binds().add("logdir", logdir);
     owner.opt_binds().add("log_size", log_size);
     owner.opt_binds().add("log_rotate", log_rotate);
@@ -562,6 +579,18 @@ OptionBool & ConfigMain::cacheonly() {
 OptionBool & ConfigMain::keepcache() {
     return p_impl->keepcache;
 }
+OptionEnum<std::string> & ConfigMain::solv_cache_compression() {
+    return p_impl->solv_cache_compression;
+}
+OptionNumber<std::uint64_t> & ConfigMain::cache_size_limit() {
+    return p_impl->cache_size_limit;
+}
+OptionSeconds & ConfigMain::cache_max_age() {
+    return p_impl->cache_max_age;
+}
+OptionSeconds & ConfigMain::cache_gc_interval() {
+    return p_impl->cache_gc_interval;
+}
 OptionString & ConfigMain::logdir() {
     return p_impl->logdir;
 }
@@ -0,0 +1,244 @@
+/*
+Copyright (C) 2018-2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "cache_manager.hpp"
+
+#include "repo_impl.hpp"
+
+#include <fmt/format.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+// Time stamp of the last scan of the cachedir
+constexpr const char * GC_STAMP_FILENAME = "cache-gc.stamp";
+
+// Length of the hash suffix of the repository cache directory names ("<repoid>-<16 hex digits>")
+constexpr std::size_t REPO_CACHEDIR_HASH_LENGTH = 16;
+
+// A file or directory tree which can be removed from the cache
+struct CacheEntry {
+    std::filesystem::path path;
+    std::uint64_t size{0};
+    std::time_t last_use{0};
+};
+
+bool ends_with(const std::string & str, const std::string & suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Adds the size of the regular file and its last access or modification time to the entry
+void add_file(const std::filesystem::path & path, CacheEntry & entry) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+        entry.size += static_cast<std::uint64_t>(st.st_size);
+        entry.last_use = std::max({entry.last_use, st.st_atime, st.st_mtime});
+    }
+}
+
+// Adds all regular files of the directory tree to the entry
+void add_tree(const std::filesystem::path & path, CacheEntry & entry) {
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        add_file(it->path(), entry);
+    }
+}
+
+// Solv cache files written by SolvSack: "<repoid>.solv", "<repoid>-<extension>.solvx" and "<repoid>-repomd.stat"
+bool is_solv_cache_file(const std::string & name) {
+    return ends_with(name, ".solv") || ends_with(name, ".solvx") || ends_with(name, "-repomd.stat");
+}
+
+bool is_repo_solv_cache_file(const std::string & name, const std::string & repo_id) {
+    if (name == repo_id + ".solv" || name == repo_id + "-repomd.stat") {
+        return true;
+    }
+    auto prefix = repo_id + "-";
+    if (name.compare(0, prefix.size(), prefix) != 0 || !ends_with(name, ".solvx")) {
+        return false;
+    }
+    return name.find('-', prefix.size()) == std::string::npos;
+}
+
+bool is_repo_cachedir_name(const std::string & name) {
+    if (name.size() <= REPO_CACHEDIR_HASH_LENGTH + 1 || name[name.size() - REPO_CACHEDIR_HASH_LENGTH - 1] != '-') {
+        return false;
+    }
+    return std::all_of(name.end() - REPO_CACHEDIR_HASH_LENGTH, name.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+    });
+}
+
+}  // namespace
+
+
+std::uint64_t CacheManager::collect(const std::vector<Repo *> & referenced_repos, bool force) {
+    auto & config = base->get_config();
+    auto size_limit = config.cache_size_limit().get_value();
+    auto max_age = config.cache_max_age().get_value();
+    if (size_limit == 0 && max_age < 0) {
+        return 0;
+    }
+
+    std::filesystem::path cachedir = config.cachedir().get_value();
+    auto stamp_path = cachedir / GC_STAMP_FILENAME;
+    auto now = std::time(nullptr);
+    if (!force) {
+        // -1 ("never") disables the periodic scan, only the forced one is done
+        auto gc_interval = config.cache_gc_interval().get_value();
+        struct stat stamp_st;
+        if (gc_interval < 0 || (stat(stamp_path.c_str(), &stamp_st) == 0 && now - stamp_st.st_mtime < gc_interval)) {
+            return 0;
+        }
+    }
+
+    // current metadata files of the loaded repositories by the names of their cachedirs, the metadata
+    // of a repository which was not loaded (e.g. skipped as unavailable) are not known and are all kept
+    std::set<std::string> repo_cachedirs;
+    std::map<std::string, std::set<std::string>> loaded_metadata_files;
+    for (auto repo : referenced_repos) {
+        auto repo_cachedir = std::filesystem::path(repo->p_impl->get_cachedir()).filename();
+        repo_cachedirs.insert(repo_cachedir);
+        if (!repo->p_impl->repomd_fn.empty()) {
+            auto & metadata_files = loaded_metadata_files[repo_cachedir];
+            metadata_files.insert(repo->p_impl->repomd_fn);
+            for (auto & [type, path] : repo->p_impl->metadata_paths) {
+                metadata_files.insert(path);
+            }
+        }
+    }
+
+    std::uint64_t total_size{0};
+    std::vector<CacheEntry> candidates;
+    auto add_candidate = [&](CacheEntry && entry) {
+        total_size += entry.size;
+        candidates.push_back(std::move(entry));
+    };
+    auto add_kept = [&](const std::filesystem::path & path, bool is_dir) {
+        CacheEntry entry;
+        is_dir ? add_tree(path, entry) : add_file(path, entry);
+        total_size += entry.size;
+    };
+
+    std::error_code ec;
+    for (auto & dir_entry : std::filesystem::directory_iterator(cachedir, ec)) {
+        auto & path = dir_entry.path();
+        auto name = path.filename().native();
+        if (dir_entry.is_symlink(ec)) {
+            continue;
+        }
+        if (dir_entry.is_regular_file(ec)) {
+            bool referenced = name == "@System.solv" ||
+                              std::any_of(referenced_repos.begin(), referenced_repos.end(), [&name](Repo * repo) {
+                                  return is_repo_solv_cache_file(name, repo->get_id());
+                              });
+            if (!referenced && is_solv_cache_file(name)) {
+                CacheEntry entry{path};
+                add_file(path, entry);
+                add_candidate(std::move(entry));
+            } else {
+                add_kept(path, false);
+            }
+        } else if (dir_entry.is_directory(ec) && is_repo_cachedir_name(name)) {
+            if (repo_cachedirs.count(name) == 0) {
+                // cache of a removed or disabled repository, or of a repository with changed urls
+                CacheEntry entry{path};
+                add_tree(path, entry);
+                add_candidate(std::move(entry));
+                continue;
+            }
+            auto metadata_files = loaded_metadata_files.find(name);
+            for (auto & repo_entry : std::filesystem::directory_iterator(path, ec)) {
+                auto subdir = repo_entry.path().filename();
+                bool is_dir = repo_entry.is_directory(ec) && !repo_entry.is_symlink(ec);
+                if (!is_dir || (subdir != "packages" && subdir != "repodata")) {
+                    add_kept(repo_entry.path(), is_dir);
+                    continue;
+                }
+                for (auto & file_entry : std::filesystem::directory_iterator(repo_entry.path(), ec)) {
+                    auto & file_path = file_entry.path();
+                    bool removable = subdir == "packages" ||
+                                     (metadata_files != loaded_metadata_files.end() &&
+                                      metadata_files->second.count(file_path.native()) == 0);
+                    if (removable && file_entry.is_regular_file(ec) && !file_entry.is_symlink(ec)) {
+                        // downloaded package or metadata of an older version of the repository
+                        CacheEntry entry{file_path};
+                        add_file(file_path, entry);
+                        add_candidate(std::move(entry));
+                    } else {
+                        add_kept(file_path, file_entry.is_directory(ec));
+                    }
+                }
+            }
+        } else {
+            add_kept(path, dir_entry.is_directory(ec));
+        }
+    }
+
+    auto & logger = base->get_logger();
+    std::uint64_t freed_size{0};
+    auto remove_entry = [&](const CacheEntry & entry) {
+        std::error_code remove_ec;
+        std::filesystem::remove_all(entry.path, remove_ec);
+        if (remove_ec) {
+            logger.warning(
+                fmt::format("cannot remove cache file \"{}\": {}", entry.path.native(), remove_ec.message()));
+            return;
+        }
+        logger.debug(fmt::format("removed cache file \"{}\"", entry.path.native()));
+        total_size -= entry.size;
+        freed_size += entry.size;
+    };
+
+    // the least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](const CacheEntry & lhs, const CacheEntry & rhs) {
+        return lhs.last_use < rhs.last_use;
+    });
+    for (auto & entry : candidates) {
+        bool expired = max_age >= 0 && now - entry.last_use > max_age;
+        bool over_budget = size_limit != 0 && total_size > size_limit;
+        if (!expired && !over_budget) {
+            // the following entries were used later
+            break;
+        }
+        remove_entry(entry);
+    }
+    if (size_limit != 0 && total_size > size_limit) {
+        logger.warning(fmt::format(
+            "cachedir \"{}\" exceeds cache_size_limit, {} bytes are used by the enabled repositories",
+            cachedir.native(),
+            total_size));
+    }
+
+    std::ofstream stamp(stamp_path, std::ios::trunc);
+    return freed_size;
+}
+
+}  // namespace libdnf::rpm
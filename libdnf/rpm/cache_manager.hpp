@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2018-2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_RPM_CACHE_MANAGER_HPP
+#define LIBDNF_RPM_CACHE_MANAGER_HPP
+
+#include "libdnf/base/base.hpp"
+#include "libdnf/rpm/repo.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+/// Removes files not needed anymore from the cachedir.
+/// The solv cache files and the current metadata of the referenced repositories are kept, all the metadata
+/// of a referenced repository which is not loaded (its current metadata are not known). The other cache files
+/// (packages, old metadata, caches of removed or disabled repositories) are removed when they were not used
+/// for the "cache_max_age" time. When the cachedir is larger than "cache_size_limit", they are removed in the least
+/// recently used order until the cachedir fits. Unknown files in the cachedir are never removed.
+/// The size of the cachedir is not tracked between the runs, it is measured by a scan of the whole cachedir.
+/// To limit the I/O the scan is done at most once per "cache_gc_interval", also when the cachedir is under
+/// the limit.
+class CacheManager {
+public:
+    explicit CacheManager(Base & base) : base(&base) {}
+
+    /// Runs the garbage collection, `referenced_repos` are the repositories in use (the enabled ones).
+    /// No file is accessed when neither limit is set. The cachedir is scanned at most once per "cache_gc_interval",
+    /// otherwise only the time stamp of the last scan is checked, and never when the interval is -1 ("never").
+    /// With `force` the cachedir is always scanned.
+    /// Returns the number of freed bytes.
+    std::uint64_t collect(const std::vector<Repo *> & referenced_repos, bool force = false);
+
+private:
+    Base * base;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_CACHE_MANAGER_HPP
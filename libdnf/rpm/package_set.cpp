@@ -112,4 +112,18 @@ SolvSack * PackageSet::get_sack() const {
 }
 
 
+void PackageSet::iterate_sorted(SortOrder order, const std::function<void(Package)> & callback) const {
+    auto sack = pImpl->get_sack();
+    switch (order) {
+        case SortOrder::NEVRA:
+            for (PackageId id : sack->pImpl->get_nevra_sorted_solvables()) {
+                if (pImpl->contains(id)) {
+                    callback(Package(sack, id));
+                }
+            }
+            break;
+    }
+}
+
+
 }  // namespace libdnf::rpm
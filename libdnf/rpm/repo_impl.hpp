@@ -101,6 +101,9 @@ public:
     int main_nrepodata{0};
     int main_end{0};
 
+    // extensions requested when the repository was loaded into the sack
+    SolvSack::LoadRepoFlags load_flags{SolvSack::LoadRepoFlags::NONE};
+
 private:
     bool needs_internalizing{false};
 };
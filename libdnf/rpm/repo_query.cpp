@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libdnf/rpm/repo_query.hpp"
+
+#include "libdnf/rpm/repo_sack.hpp"
+
+#include <algorithm>
+
+namespace libdnf::rpm {
+
+RepoQuery & RepoQuery::ifilter_id(sack::QueryCmp cmp, const std::string & pattern) {
+    if (sack && (cmp == sack::QueryCmp::EQ || cmp == sack::QueryCmp::IEXACT)) {
+        filter_id_indexed(cmp == sack::QueryCmp::IEXACT, {pattern});
+    } else {
+        ifilter(F::id, cmp, pattern);
+    }
+    return *this;
+}
+
+RepoQuery & RepoQuery::ifilter_id(sack::QueryCmp cmp, const std::vector<std::string> & patterns) {
+    if (sack && (cmp == sack::QueryCmp::EQ || cmp == sack::QueryCmp::IEXACT)) {
+        filter_id_indexed(cmp == sack::QueryCmp::IEXACT, patterns);
+    } else {
+        ifilter(F::id, cmp, patterns);
+    }
+    return *this;
+}
+
+void RepoQuery::filter_id_indexed(bool icase, const std::vector<std::string> & patterns) {
+    std::vector<RepoWeakPtr> found;
+    for (auto & pattern : patterns) {
+        sack->find_repos_by_id(pattern, icase, found);
+    }
+    // the index covers the whole sack, keep only the repositories present in the query
+    found.erase(
+        std::remove_if(found.begin(), found.end(), [this](const RepoWeakPtr & repo) { return !contains(repo); }),
+        found.end());
+    clear();
+    add(found.begin(), found.end());
+}
+
+}  // namespace libdnf::rpm
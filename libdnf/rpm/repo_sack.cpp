@@ -17,6 +17,8 @@ You should have received a copy of the GNU Lesser General Public License
 along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "cache_manager.hpp"
+
 #include "libdnf/rpm/repo_sack.hpp"
 
 #include "libdnf/base/base.hpp"
@@ -25,15 +27,114 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace libdnf::rpm {
 
+static std::string tolower(std::string s) {
+    std::transform(
+        s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
 RepoWeakPtr RepoSack::new_repo(const std::string & id) {
     // TODO(jrohel): Test repo exists
     auto repo_config = std::make_unique<ConfigRepo>(base->get_config());
     auto repo = std::make_unique<Repo>(id, std::move(repo_config), *base, Repo::Type::AVAILABLE);
-    return add_item_with_return(std::move(repo));
+    auto repo_weak = add_item_with_return(std::move(repo));
+    id_index.emplace(tolower(id), repo_weak);
+    return repo_weak;
+}
+
+RepoQuery RepoSack::new_query() {
+    auto query = Sack::new_query();
+    query.sack = this;
+    return query;
+}
+
+std::uint64_t RepoSack::collect_cache_garbage(bool force) {
+    std::vector<Repo *> enabled_repos;
+    for (auto & repo : new_query().ifilter_enabled(true).get_data()) {
+        enabled_repos.push_back(repo.get());
+    }
+    return CacheManager(*base).collect(enabled_repos, force);
+}
+
+std::vector<RepoLoadResult> RepoSack::load_all(
+    const RepoQuery & repos,
+    std::size_t parallelism,
+    const std::function<void(const RepoLoadResult &)> & on_result) {
+    std::vector<RepoLoadResult> results;
+    for (auto & repo : repos.get_data()) {
+        results.push_back({repo, nullptr});
+    }
+    std::sort(results.begin(), results.end(), [](const RepoLoadResult & lhs, const RepoLoadResult & rhs) {
+        return lhs.repo->get_id() < rhs.repo->get_id();
+    });
+
+    // the workers take the repositories in order, each result is written by one worker only
+    std::atomic<std::size_t> next_idx{0};
+    std::mutex done_mutex;
+    std::condition_variable result_done;
+    std::vector<bool> done(results.size(), false);
+    auto worker = [&]() {
+        for (std::size_t idx = next_idx++; idx < results.size(); idx = next_idx++) {
+            try {
+                results[idx].repo->load();
+            } catch (...) {
+                results[idx].error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(done_mutex);
+                done[idx] = true;
+            }
+            result_done.notify_one();
+        }
+    };
+    auto num_workers = std::min(std::max(parallelism, std::size_t{1}), results.size());
+    std::vector<std::thread> threads;
+    auto join_workers = [&]() {
+        for (auto & thread : threads) {
+            thread.join();
+        }
+    };
+
+    // the calling thread reports the results in order while the workers are loading the next repositories
+    try {
+        for (std::size_t idx = 0; idx < num_workers; ++idx) {
+            threads.emplace_back(worker);
+        }
+        for (std::size_t idx = 0; idx < results.size(); ++idx) {
+            {
+                std::unique_lock<std::mutex> lock(done_mutex);
+                result_done.wait(lock, [&done, idx]() { return done[idx]; });
+            }
+            if (on_result) {
+                on_result(results[idx]);
+            }
+        }
+    } catch (...) {
+        next_idx = results.size();
+        join_workers();
+        throw;
+    }
+    join_workers();
+    return results;
+}
+
+void RepoSack::find_repos_by_id(const std::string & id, bool icase, std::vector<RepoWeakPtr> & result) const {
+    auto [first, last] = id_index.equal_range(tolower(id));
+    for (auto it = first; it != last; ++it) {
+        if (icase || it->second->get_id() == id) {
+            result.push_back(it->second);
+        }
+    }
 }
 
 static void load_config_from_parser(
@@ -36,8 +36,15 @@ extern "C" {
 #include <solv/solver.h>
 }
 
+#include <fmt/format.h>
 #include <fnmatch.h>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <thread>
+
 namespace {
 
 inline bool is_valid_candidate(
@@ -60,8 +67,28 @@ inline bool is_valid_candidate(
     }
 }
 
+/// Writes decimal representation of the epoch into the buffer and returns pointer to it
+inline const char * epoch_to_cstring(unsigned long epoch, char (&buffer)[24]) {
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer) - 1, epoch);
+    *result.ptr = '\0';
+    return buffer;
+}
+
+/// Parses an epoch pattern. Returns false when the pattern is not a decimal number in the form
+/// in which epochs are stored (no sign, no leading zeros), it cannot be equal to any epoch then.
+inline bool parse_epoch_pattern(const char * c_pattern, unsigned long & epoch) {
+    if (!std::isdigit(static_cast<unsigned char>(*c_pattern)) || (c_pattern[0] == '0' && c_pattern[1] != '\0')) {
+        return false;
+    }
+    auto pattern_end = c_pattern + strlen(c_pattern);
+    auto result = std::from_chars(c_pattern, pattern_end, epoch);
+    return result.ec == std::errc() && result.ptr == pattern_end;
+}
+
 bool is_valid_candidate(
     Pool * pool,
+    Stringpool * evr_strings,
+    const libdnf::rpm::SolvableEvr & candidate_evr,
     libdnf::rpm::PackageId candidate_id,
     Id src,
     bool test_epoch,
@@ -88,19 +115,20 @@ bool is_valid_candidate(
         }
     }
     if (test_epoch) {
-        auto candidate_epoch = libdnf::rpm::solv::get_epoch_cstring(pool, candidate_id);
+        char epoch_buffer[24];
+        auto candidate_epoch = epoch_to_cstring(candidate_evr.epoch, epoch_buffer);
         if (!is_valid_candidate(epoch_cmp_type, epoch_c_pattern, candidate_epoch)) {
             return false;
         }
     }
     if (test_version) {
-        auto candidate_version = libdnf::rpm::solv::get_version(pool, candidate_id);
+        auto candidate_version = stringpool_id2str(evr_strings, candidate_evr.version);
         if (!is_valid_candidate(version_cmp_type, version_c_pattern, candidate_version)) {
             return false;
         }
     }
     if (test_release) {
-        auto candidate_release = libdnf::rpm::solv::get_release(pool, candidate_id);
+        auto candidate_release = stringpool_id2str(evr_strings, candidate_evr.release);
         if (!is_valid_candidate(release_cmp_type, release_c_pattern, candidate_release)) {
             return false;
         }
@@ -136,8 +164,27 @@ static inline bool name_compare_lower_id(const Solvable * first, Id id_name) {
 
 class SolvQuery::Impl {
 public:
+    /// Records `FilterStats` of one filter call when profiling of the query is enabled.
+    /// A disabled profiler only tests the flag, it does not allocate nor read the clock.
+    class FilterProfiler {
+    public:
+        FilterProfiler(SolvQuery::Impl & query, const char * filter_name, libdnf::sack::QueryCmp cmp_type);
+        FilterProfiler(const FilterProfiler & src) = delete;
+        FilterProfiler & operator=(const FilterProfiler & src) = delete;
+        ~FilterProfiler();
+
+        void mark_indexed() noexcept { stats.indexed = true; }
+
+    private:
+        /// nullptr when the filter is not recorded
+        SolvQuery::Impl * query{nullptr};
+        int uncaught_exceptions{0};
+        std::chrono::steady_clock::time_point start;
+        FilterStats stats;
+    };
+
     Impl(SolvSack * sack, InitFlags flags);
-    Impl(const SolvQuery::Impl & src) = default;
+    Impl(const SolvQuery::Impl & src);
     Impl(const SolvQuery::Impl && src) = delete;
     ~Impl() = default;
 
@@ -159,16 +206,28 @@ public:
         bool with_src);
     void filter_nevra(
         Pool * pool,
-        const std::vector<Solvable *> sorted_solvables,
+        const std::vector<PackageId> & sorted_solvables,
         const std::string & pattern,
         bool cmp_glob,
         libdnf::sack::QueryCmp cmp_type,
         solv::SolvMap & filter_result);
 
+    /// Notes that the currently profiled filter used an index instead of testing each candidate
+    void mark_indexed() noexcept {
+        if (active_profiler) {
+            active_profiler->mark_indexed();
+        }
+    }
+
 private:
     friend class SolvQuery;
     SolvSackWeakPtr sack;
     solv::SolvMap query_result;
+    unsigned int num_workers{1};
+    bool profiling{false};
+    std::vector<FilterStats> filter_stats;
+    /// Profiler of the outermost running filter call, nested filter calls are not recorded separately
+    FilterProfiler * active_profiler{nullptr};
 };
 
 SolvQuery::SolvQuery(SolvSack * sack, InitFlags flags) : p_impl(new Impl(sack, flags)) {}
@@ -181,8 +240,7 @@ SolvQuery & SolvQuery::operator=(const SolvQuery & src) {
     if (this == &src) {
         return *this;
     }
-    p_impl->query_result = src.p_impl->query_result;
-    p_impl->sack = src.p_impl->sack;
+    *p_impl = *src.p_impl;
     return *this;
 }
 
@@ -207,21 +265,75 @@ SolvQuery::Impl::Impl(SolvSack * sack, InitFlags flags)
     }
 }
 
+SolvQuery::Impl::Impl(const SolvQuery::Impl & src)
+    : sack(src.sack)
+    , query_result(src.query_result)
+    , num_workers(src.num_workers)
+    , profiling(src.profiling)
+    , filter_stats(src.filter_stats) {}
+
 SolvQuery::Impl & SolvQuery::Impl::operator=(const SolvQuery::Impl & src) {
     if (this == &src) {
         return *this;
     }
     query_result = src.query_result;
     sack = src.sack;
+    num_workers = src.num_workers;
+    profiling = src.profiling;
+    filter_stats = src.filter_stats;
     return *this;
 }
 
 SolvQuery::Impl & SolvQuery::Impl::operator=(SolvQuery::Impl && src) noexcept {
     std::swap(query_result, src.query_result);
     std::swap(sack, src.sack);
+    std::swap(num_workers, src.num_workers);
+    std::swap(profiling, src.profiling);
+    std::swap(filter_stats, src.filter_stats);
     return *this;
 }
 
+SolvQuery::Impl::FilterProfiler::FilterProfiler(
+    SolvQuery::Impl & query, const char * filter_name, libdnf::sack::QueryCmp cmp_type) {
+    if (!query.profiling || query.active_profiler) {
+        return;
+    }
+    this->query = &query;
+    query.active_profiler = this;
+    uncaught_exceptions = std::uncaught_exceptions();
+    stats.filter_name = filter_name;
+    stats.cmp_type = cmp_type;
+    stats.input_size = query.query_result.size();
+    start = std::chrono::steady_clock::now();
+}
+
+SolvQuery::Impl::FilterProfiler::~FilterProfiler() {
+    if (!query) {
+        return;
+    }
+    query->active_profiler = nullptr;
+    // the filter failed, there is no result to record
+    if (std::uncaught_exceptions() > uncaught_exceptions) {
+        return;
+    }
+    stats.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats.output_size = query->query_result.size();
+    try {
+        query->filter_stats.push_back(stats);
+        auto & logger = query->sack->pImpl->get_base().get_logger();
+        logger.debug(fmt::format(
+            "SolvQuery::{}(cmp_type={:#x}): {} -> {} packages in {} us, {}",
+            stats.filter_name,
+            static_cast<unsigned int>(stats.cmp_type),
+            stats.input_size,
+            stats.output_size,
+            std::chrono::duration_cast<std::chrono::microseconds>(stats.duration).count(),
+            stats.indexed ? "indexed" : "full scan"));
+    } catch (...) {
+        // profiling must not break the query
+    }
+}
+
 PackageSet SolvQuery::get_package_set() {
     return PackageSet(p_impl->sack.get(), p_impl->query_result);
 }
@@ -242,6 +354,7 @@ inline static void filter_glob_internal(
 }
 
 SolvQuery & SolvQuery::ifilter_name(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_name", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
     auto & sorted_solvables = p_impl->sack->pImpl->get_sorted_solvables();
@@ -264,14 +377,17 @@ SolvQuery & SolvQuery::ifilter_name(libdnf::sack::QueryCmp cmp_type, const std::
 
         switch (tmp_cmp_type) {
             case libdnf::sack::QueryCmp::EQ: {
+                p_impl->mark_indexed();
                 Id name_id = pool_str2id(pool, pattern.c_str(), 0);
                 if (name_id == 0) {
                     continue;
                 }
-                auto low =
-                    std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), name_id, name_compare_lower_id);
-                while (low != sorted_solvables.end() && (*low)->name == name_id) {
-                    filter_result.add_unsafe(solv::get_package_id(pool, *low));
+                auto low = std::lower_bound(
+                    sorted_solvables.begin(), sorted_solvables.end(), name_id, [pool](PackageId id, Id name_id) {
+                        return name_compare_lower_id(solv::get_solvable(pool, id), name_id);
+                    });
+                while (low != sorted_solvables.end() && solv::get_solvable(pool, *low)->name == name_id) {
+                    filter_result.add_unsafe(*low);
                     ++low;
                 }
             } break;
@@ -359,6 +475,7 @@ inline static void filter_evr_internal(
 }
 
 SolvQuery & SolvQuery::ifilter_evr(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_evr", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
     switch (cmp_type) {
         case libdnf::sack::QueryCmp::GT:
@@ -383,6 +500,7 @@ SolvQuery & SolvQuery::ifilter_evr(libdnf::sack::QueryCmp cmp_type, const std::v
 }
 
 SolvQuery & SolvQuery::ifilter_arch(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_arch", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
@@ -532,23 +650,30 @@ template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_nevra_internal(
     Pool * pool,
     const char * c_pattern,
-    const std::vector<Solvable *> & sorted_solvables,
+    const std::vector<PackageId> & sorted_solvables,
     solv::SolvMap & filter_result) {
     NevraID nevra_id;
     if (!nevra_id.parse(pool, c_pattern, false)) {
         return;
     }
-    auto low = std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), nevra_id, name_arch_compare_lower_id);
-    while (low != sorted_solvables.end() && (*low)->name == nevra_id.name && (*low)->arch == nevra_id.arch) {
-        int cmp = pool_evrcmp_str(pool, pool_id2str(pool, (*low)->evr), nevra_id.evr_str.c_str(), EVRCMP_COMPARE);
+    auto low = std::lower_bound(
+        sorted_solvables.begin(), sorted_solvables.end(), nevra_id, [pool](PackageId id, const NevraID & nevra_id) {
+            return name_arch_compare_lower_id(solv::get_solvable(pool, id), nevra_id);
+        });
+    for (; low != sorted_solvables.end(); ++low) {
+        Solvable * solvable = solv::get_solvable(pool, *low);
+        if (solvable->name != nevra_id.name || solvable->arch != nevra_id.arch) {
+            break;
+        }
+        int cmp = pool_evrcmp_str(pool, pool_id2str(pool, solvable->evr), nevra_id.evr_str.c_str(), EVRCMP_COMPARE);
         if (cmp_fnc(cmp)) {
-            filter_result.add_unsafe(solv::get_package_id(pool, *low));
+            filter_result.add_unsafe(*low);
         }
-        ++low;
     }
 }
 
 SolvQuery & SolvQuery::ifilter_nevra(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_nevra", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -577,6 +702,7 @@ SolvQuery & SolvQuery::ifilter_nevra(libdnf::sack::QueryCmp cmp_type, const std:
 }
 
 SolvQuery & SolvQuery::ifilter_nevra(libdnf::sack::QueryCmp cmp_type, const libdnf::rpm::Nevra & pattern) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_nevra", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -599,22 +725,63 @@ SolvQuery & SolvQuery::ifilter_nevra(libdnf::sack::QueryCmp cmp_type, const libd
     return *this;
 }
 
+/// Compares versions (or releases) of candidates with the pattern. The comparison is done only once for each
+/// distinct version Id, candidates with the same version reuse the result.
+/// @param evr_part_ptr pointer to the compared member of SolvableEvr (version or release)
+/// @param format_evr_part function that turns a version (or release) into an evr acceptable by pool_evrcmp_str()
 template <bool (*cmp_fnc)(int value_to_cmp)>
-inline static void filter_version_internal(
-    Pool * pool, const char * c_pattern, solv::SolvMap & candidates, solv::SolvMap & filter_result) {
-    char * formated_c_pattern = solv_dupjoin(c_pattern, "-0", nullptr);
+inline static void filter_evr_part_internal(
+    Pool * pool,
+    Stringpool * evr_strings,
+    const std::vector<SolvableEvr> & solvables_evr,
+    Id SolvableEvr::*evr_part_ptr,
+    const char * (*format_evr_part)(Pool * pool, const char * evr_part),
+    const char * c_pattern,
+    solv::SolvMap & candidates,
+    solv::SolvMap & filter_result) {
+    char * formated_c_pattern = solv_strdup(format_evr_part(pool, c_pattern));
+    // result of comparison for each evr part Id: -1 not compared yet, 0 does not match, 1 matches
+    std::vector<signed char> id_matches(static_cast<size_t>(evr_strings->nstrings), -1);
     for (PackageId candidate_id : candidates) {
-        const char * version = solv::get_version(pool, candidate_id);
-        char * vr = pool_tmpjoin(pool, version, "-0", nullptr);
-        int cmp = pool_evrcmp_str(pool, vr, formated_c_pattern, EVRCMP_COMPARE);
-        if (cmp_eq(cmp)) {
+        auto evr_part_id = solvables_evr[static_cast<size_t>(candidate_id.id)].*evr_part_ptr;
+        auto & matches = id_matches[static_cast<size_t>(evr_part_id)];
+        if (matches < 0) {
+            const char * evr = format_evr_part(pool, stringpool_id2str(evr_strings, evr_part_id));
+            matches = cmp_fnc(pool_evrcmp_str(pool, evr, formated_c_pattern, EVRCMP_COMPARE)) ? 1 : 0;
+        }
+        if (matches) {
             filter_result.add_unsafe(candidate_id);
         }
     }
     solv_free(formated_c_pattern);
 }
 
+/// @return const char* !! Return temporal value !!
+inline static const char * version_to_evr(Pool * pool, const char * version) {
+    return pool_tmpjoin(pool, version, "-0", nullptr);
+}
+
+template <bool (*cmp_fnc)(int value_to_cmp)>
+inline static void filter_version_internal(
+    Pool * pool,
+    Stringpool * evr_strings,
+    const std::vector<SolvableEvr> & solvables_evr,
+    const char * c_pattern,
+    solv::SolvMap & candidates,
+    solv::SolvMap & filter_result) {
+    filter_evr_part_internal<cmp_fnc>(
+        pool,
+        evr_strings,
+        solvables_evr,
+        &SolvableEvr::version,
+        version_to_evr,
+        c_pattern,
+        candidates,
+        filter_result);
+}
+
 SolvQuery & SolvQuery::ifilter_version(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_version", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -623,6 +790,8 @@ SolvQuery & SolvQuery::ifilter_version(libdnf::sack::QueryCmp cmp_type, const st
 
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
     Pool * pool = p_impl->sack->pImpl->get_pool();
+    auto & solvables_evr = p_impl->sack->pImpl->get_solvables_evr();
+    Stringpool * evr_strings = p_impl->sack->pImpl->get_evr_strings();
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
 
     for (auto & pattern : patterns) {
@@ -634,22 +803,27 @@ SolvQuery & SolvQuery::ifilter_version(libdnf::sack::QueryCmp cmp_type, const st
         }
         switch (tmp_cmp_type) {
             case libdnf::sack::QueryCmp::EQ:
-                filter_version_internal<cmp_eq>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_version_internal<cmp_eq>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::GLOB:
                 filter_glob_internal<solv::get_version>(pool, c_pattern, p_impl->query_result, filter_result, 0);
                 break;
             case libdnf::sack::QueryCmp::GT:
-                filter_version_internal<cmp_gt>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_version_internal<cmp_gt>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::LT:
-                filter_version_internal<cmp_lt>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_version_internal<cmp_lt>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::GTE:
-                filter_version_internal<cmp_gte>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_version_internal<cmp_gte>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::LTE:
-                filter_version_internal<cmp_lte>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_version_internal<cmp_lte>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             default:
                 throw NotSupportedCmpType("Used unsupported CmpType");
@@ -666,22 +840,32 @@ SolvQuery & SolvQuery::ifilter_version(libdnf::sack::QueryCmp cmp_type, const st
     return *this;
 }
 
+/// @return const char* !! Return temporal value !!
+inline static const char * release_to_evr(Pool * pool, const char * release) {
+    return pool_tmpjoin(pool, "0-", release, nullptr);
+}
+
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_release_internal(
-    Pool * pool, const char * c_pattern, solv::SolvMap & candidates, solv::SolvMap & filter_result) {
-    char * formated_c_pattern = solv_dupjoin("0-", c_pattern, nullptr);
-    for (PackageId candidate_id : candidates) {
-        const char * release = solv::get_release(pool, candidate_id);
-        char * vr = pool_tmpjoin(pool, "0-", release, nullptr);
-        int cmp = pool_evrcmp_str(pool, vr, formated_c_pattern, EVRCMP_COMPARE);
-        if (cmp_eq(cmp)) {
-            filter_result.add_unsafe(candidate_id);
-        }
-    }
-    solv_free(formated_c_pattern);
+    Pool * pool,
+    Stringpool * evr_strings,
+    const std::vector<SolvableEvr> & solvables_evr,
+    const char * c_pattern,
+    solv::SolvMap & candidates,
+    solv::SolvMap & filter_result) {
+    filter_evr_part_internal<cmp_fnc>(
+        pool,
+        evr_strings,
+        solvables_evr,
+        &SolvableEvr::release,
+        release_to_evr,
+        c_pattern,
+        candidates,
+        filter_result);
 }
 
 SolvQuery & SolvQuery::ifilter_release(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_release", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -690,6 +874,8 @@ SolvQuery & SolvQuery::ifilter_release(libdnf::sack::QueryCmp cmp_type, const st
 
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
     Pool * pool = p_impl->sack->pImpl->get_pool();
+    auto & solvables_evr = p_impl->sack->pImpl->get_solvables_evr();
+    Stringpool * evr_strings = p_impl->sack->pImpl->get_evr_strings();
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
 
     for (auto & pattern : patterns) {
@@ -701,22 +887,27 @@ SolvQuery & SolvQuery::ifilter_release(libdnf::sack::QueryCmp cmp_type, const st
         }
         switch (tmp_cmp_type) {
             case libdnf::sack::QueryCmp::EQ:
-                filter_release_internal<cmp_eq>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_release_internal<cmp_eq>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::GLOB:
                 filter_glob_internal<solv::get_release>(pool, c_pattern, p_impl->query_result, filter_result, 0);
                 break;
             case libdnf::sack::QueryCmp::GT:
-                filter_release_internal<cmp_gt>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_release_internal<cmp_gt>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::LT:
-                filter_release_internal<cmp_lt>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_release_internal<cmp_lt>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::GTE:
-                filter_release_internal<cmp_gte>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_release_internal<cmp_gte>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             case libdnf::sack::QueryCmp::LTE:
-                filter_release_internal<cmp_lte>(pool, c_pattern, p_impl->query_result, filter_result);
+                filter_release_internal<cmp_lte>(
+                    pool, evr_strings, solvables_evr, c_pattern, p_impl->query_result, filter_result);
                 break;
             default:
                 throw NotSupportedCmpType("Used unsupported CmpType");
@@ -734,6 +925,7 @@ SolvQuery & SolvQuery::ifilter_release(libdnf::sack::QueryCmp cmp_type, const st
 }
 
 SolvQuery & SolvQuery::ifilter_reponame(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_reponame", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -796,6 +988,7 @@ SolvQuery & SolvQuery::ifilter_reponame(libdnf::sack::QueryCmp cmp_type, const s
 }
 
 SolvQuery & SolvQuery::ifilter_sourcerpm(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_sourcerpm", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -855,7 +1048,24 @@ SolvQuery & SolvQuery::ifilter_sourcerpm(libdnf::sack::QueryCmp cmp_type, const
     return *this;
 }
 
+template <bool (*cmp_fnc)(int value_to_cmp)>
+inline static void filter_epoch_internal(
+    const std::vector<SolvableEvr> & solvables_evr,
+    const std::vector<unsigned long> & patterns,
+    solv::SolvMap & candidates,
+    solv::SolvMap & filter_result) {
+    for (auto pattern : patterns) {
+        for (PackageId candidate_id : candidates) {
+            auto candidate_epoch = solvables_evr[static_cast<size_t>(candidate_id.id)].epoch;
+            if (cmp_fnc((candidate_epoch > pattern) - (candidate_epoch < pattern))) {
+                filter_result.add_unsafe(candidate_id);
+            }
+        }
+    }
+}
+
 SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std::vector<unsigned long> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_epoch", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -863,58 +1073,23 @@ SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std:
     }
 
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
-    Pool * pool = p_impl->sack->pImpl->get_pool();
+    auto & solvables_evr = p_impl->sack->pImpl->get_solvables_evr();
 
     switch (cmp_type) {
         case libdnf::sack::QueryCmp::EQ:
-            for (auto & pattern : patterns) {
-                for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch(pool, candidate_id);
-                    if (candidate_epoch == pattern) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            }
+            filter_epoch_internal<cmp_eq>(solvables_evr, patterns, p_impl->query_result, filter_result);
             break;
         case libdnf::sack::QueryCmp::GT:
-            for (auto & pattern : patterns) {
-                for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch(pool, candidate_id);
-                    if (candidate_epoch > pattern) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            }
+            filter_epoch_internal<cmp_gt>(solvables_evr, patterns, p_impl->query_result, filter_result);
             break;
         case libdnf::sack::QueryCmp::LT:
-            for (auto & pattern : patterns) {
-                for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch(pool, candidate_id);
-                    if (candidate_epoch < pattern) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            }
+            filter_epoch_internal<cmp_lt>(solvables_evr, patterns, p_impl->query_result, filter_result);
             break;
         case libdnf::sack::QueryCmp::GTE:
-            for (auto & pattern : patterns) {
-                for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch(pool, candidate_id);
-                    if (candidate_epoch >= pattern) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            }
+            filter_epoch_internal<cmp_gte>(solvables_evr, patterns, p_impl->query_result, filter_result);
             break;
         case libdnf::sack::QueryCmp::LTE:
-            for (auto & pattern : patterns) {
-                for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch(pool, candidate_id);
-                    if (candidate_epoch <= pattern) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            }
+            filter_epoch_internal<cmp_lte>(solvables_evr, patterns, p_impl->query_result, filter_result);
             break;
         default:
             throw NotSupportedCmpType("Used unsupported CmpType");
@@ -931,6 +1106,7 @@ SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std:
 }
 
 SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_epoch", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -938,7 +1114,7 @@ SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std:
     }
 
     solv::SolvMap filter_result(p_impl->sack->pImpl->get_nsolvables());
-    Pool * pool = p_impl->sack->pImpl->get_pool();
+    auto & solvables_evr = p_impl->sack->pImpl->get_solvables_evr();
 
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
 
@@ -951,17 +1127,24 @@ SolvQuery & SolvQuery::ifilter_epoch(libdnf::sack::QueryCmp cmp_type, const std:
         }
 
         switch (tmp_cmp_type) {
-            case libdnf::sack::QueryCmp::EQ:
+            case libdnf::sack::QueryCmp::EQ: {
+                // Epochs are stored as decimal numbers without leading zeros, a string comparison is then
+                // the same as a comparison of numbers
+                unsigned long epoch_pattern;
+                if (!parse_epoch_pattern(c_pattern, epoch_pattern)) {
+                    break;
+                }
                 for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch_cstring(pool, candidate_id);
-                    if (strcmp(candidate_epoch, c_pattern) == 0) {
+                    if (solvables_evr[static_cast<size_t>(candidate_id.id)].epoch == epoch_pattern) {
                         filter_result.add_unsafe(candidate_id);
                     }
                 }
-                break;
+            } break;
             case libdnf::sack::QueryCmp::GLOB:
                 for (PackageId candidate_id : p_impl->query_result) {
-                    auto candidate_epoch = solv::get_epoch_cstring(pool, candidate_id);
+                    char epoch_buffer[24];
+                    auto candidate_epoch =
+                        epoch_to_cstring(solvables_evr[static_cast<size_t>(candidate_id.id)].epoch, epoch_buffer);
                     if (fnmatch(c_pattern, candidate_epoch, 0) == 0) {
                         filter_result.add_unsafe(candidate_id);
                     }
@@ -1001,12 +1184,139 @@ static void filter_dataiterator(
     }
 }
 
+/// Calls `candidate_filter(candidate_id)` for each candidate with Id from the range <begin_id, end_id).
+template <typename CandidateFilter>
+inline static void for_each_candidate(
+    const solv::SolvMap & candidates, Id begin_id, Id end_id, CandidateFilter && candidate_filter) {
+    const unsigned char * map = candidates.get_map()->map;
+    for (Id byte_id = begin_id >> 3; byte_id < (end_id + 7) >> 3; ++byte_id) {
+        // skip all empty bytes
+        if (!map[byte_id]) {
+            continue;
+        }
+        for (Id candidate_id = byte_id << 3; candidate_id < (byte_id + 1) << 3 && candidate_id < end_id;
+             ++candidate_id) {
+            if (candidates.contains_unsafe(PackageId(candidate_id))) {
+                candidate_filter(PackageId(candidate_id));
+            }
+        }
+    }
+}
+
+/// Calls `range_filter(begin_id, end_id)` for partitions of the Id range of the `candidates` bitmap.
+/// With `num_workers` > 1, the partitions are processed by the calling thread and the threads of `workers`.
+/// The partitions are aligned to 64-bit words of the bitmap, so the workers may write their results into a shared
+/// result bitmap (each worker writes only the words of its partition) and the partial results do not need
+/// to be merged.
+template <typename RangeFilter>
+static void filter_parallel(
+    utils::ThreadPool & workers,
+    unsigned int num_workers,
+    const solv::SolvMap & candidates,
+    RangeFilter && range_filter) {
+    constexpr int WORD_BITS = 64;
+    const int nbits = candidates.get_map()->size << 3;
+    const int nwords = (nbits + WORD_BITS - 1) / WORD_BITS;
+    const int nworkers = std::min(static_cast<int>(num_workers), nwords);
+    if (nworkers <= 1) {
+        range_filter(0, nbits);
+        return;
+    }
+
+    workers.run(static_cast<size_t>(nworkers), [&](size_t idx) {
+        auto worker = static_cast<int>(idx);
+        Id begin_id = nwords * worker / nworkers * WORD_BITS;
+        Id end_id = std::min(nwords * (worker + 1) / nworkers * WORD_BITS, nbits);
+        range_filter(begin_id, end_id);
+    });
+}
+
+/// Composes the full path of the file found by the dataiterator in the filelist.
+/// Unlike repodata_dir2str() it does not use the temporary space of the pool, it can be used from several threads.
+static const char * get_file_path(
+    Pool * pool, const Dataiterator & di, std::vector<const char *> & components, std::string & path) {
+    Repodata * data = di.data;
+    Stringpool * spool = data->localpool ? &data->spool : &pool->ss;
+    components.clear();
+    for (Id dir_id = di.kv.id; dir_id; dir_id = dirpool_parent(&data->dirpool, dir_id)) {
+        components.push_back(stringpool_id2str(spool, dirpool_compid(&data->dirpool, dir_id)));
+    }
+    path.clear();
+    for (auto it = components.rbegin(); it != components.rend(); ++it) {
+        path.append(*it);
+        path.push_back('/');
+    }
+    path.append(di.kv.str);
+    return path.c_str();
+}
+
+/// Matches the string in the same way as the libsolv datamatcher does for the given cmp_type
+static bool match_dataiterator_string(libdnf::sack::QueryCmp cmp_type, const char * c_pattern, const char * str) {
+    switch (cmp_type) {
+        case libdnf::sack::QueryCmp::EQ:
+            return strcmp(str, c_pattern) == 0;
+        case libdnf::sack::QueryCmp::IEXACT:
+            return strcasecmp(str, c_pattern) == 0;
+        case libdnf::sack::QueryCmp::GLOB:
+            return fnmatch(c_pattern, str, 0) == 0;
+        case libdnf::sack::QueryCmp::IGLOB:
+            return fnmatch(c_pattern, str, FNM_CASEFOLD) == 0;
+        case libdnf::sack::QueryCmp::CONTAINS:
+            return strstr(str, c_pattern) != nullptr;
+        case libdnf::sack::QueryCmp::ICONTAINS:
+            return strcasestr(str, c_pattern) != nullptr;
+        default:
+            throw SolvQuery::NotSupportedCmpType("Used unsupported CmpType");
+    }
+}
+
+/// Parallel version of filter_dataiterator(). Each worker uses its own Dataiterator.
+/// Data of the sack must be prepared by SolvSack::Impl::prepare_parallel_read().
+static void filter_dataiterator_parallel(
+    utils::ThreadPool & workers,
+    Pool * pool,
+    Id keyname,
+    int flags,
+    libdnf::sack::QueryCmp cmp_type,
+    solv::SolvMap & candidates,
+    solv::SolvMap & filter_result,
+    const char * c_pattern,
+    unsigned int num_workers) {
+    filter_parallel(workers, num_workers, candidates, [&](Id begin_id, Id end_id) {
+        Dataiterator di;
+        std::vector<const char *> components;
+        std::string path;
+        for_each_candidate(candidates, begin_id, end_id, [&](PackageId candidate_id) {
+            if (keyname == SOLVABLE_FILELIST) {
+                // Libsolv composes full paths of files (SEARCH_FILES) in the temporary space of the pool,
+                // which cannot be shared by threads. The paths are composed and matched here instead.
+                dataiterator_init(
+                    &di, pool, nullptr, candidate_id.id, keyname, nullptr, flags & SEARCH_COMPLETE_FILELIST);
+                while (dataiterator_step(&di) != 0) {
+                    if (match_dataiterator_string(cmp_type, c_pattern, get_file_path(pool, di, components, path))) {
+                        filter_result.add_unsafe(candidate_id);
+                        break;
+                    }
+                }
+            } else {
+                dataiterator_init(&di, pool, nullptr, candidate_id.id, keyname, c_pattern, flags);
+                if (dataiterator_step(&di) != 0) {
+                    filter_result.add_unsafe(candidate_id);
+                }
+            }
+            dataiterator_free(&di);
+        });
+    });
+}
+
 static void filter_dataiterator_internal(
+    utils::ThreadPool & workers,
     Pool * pool,
     Id keyname,
     solv::SolvMap & candidates,
     libdnf::sack::QueryCmp cmp_type,
-    const std::vector<std::string> & patterns) {
+    const std::vector<std::string> & patterns,
+    unsigned int num_workers) {
     solv::SolvMap filter_result(pool->nsolvables);
 
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
@@ -1048,7 +1358,12 @@ static void filter_dataiterator_internal(
             default:
                 throw SolvQuery::NotSupportedCmpType("Used unsupported CmpType");
         }
-        filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
+        if (num_workers > 1) {
+            filter_dataiterator_parallel(
+                workers, pool, keyname, flags, tmp_cmp_type, candidates, filter_result, c_pattern, num_workers);
+        } else {
+            filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
+        }
     }
 
     // Apply filter results to query
@@ -1060,38 +1375,83 @@ static void filter_dataiterator_internal(
 }
 
 SolvQuery & SolvQuery::ifilter_file(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_file", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
 
-    filter_dataiterator_internal(pool, SOLVABLE_FILELIST, p_impl->query_result, cmp_type, patterns);
+    if (p_impl->num_workers > 1) {
+        p_impl->sack->pImpl->prepare_parallel_read(SOLVABLE_FILELIST);
+    }
+    filter_dataiterator_internal(
+        p_impl->sack->pImpl->get_query_workers(),
+        pool,
+        SOLVABLE_FILELIST,
+        p_impl->query_result,
+        cmp_type,
+        patterns,
+        p_impl->num_workers);
 
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_description(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_description", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
 
-    filter_dataiterator_internal(pool, SOLVABLE_DESCRIPTION, p_impl->query_result, cmp_type, patterns);
+    if (p_impl->num_workers > 1) {
+        p_impl->sack->pImpl->prepare_parallel_read(SOLVABLE_DESCRIPTION);
+    }
+    filter_dataiterator_internal(
+        p_impl->sack->pImpl->get_query_workers(),
+        pool,
+        SOLVABLE_DESCRIPTION,
+        p_impl->query_result,
+        cmp_type,
+        patterns,
+        p_impl->num_workers);
 
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_summary(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_summary", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
 
-    filter_dataiterator_internal(pool, SOLVABLE_SUMMARY, p_impl->query_result, cmp_type, patterns);
+    if (p_impl->num_workers > 1) {
+        p_impl->sack->pImpl->prepare_parallel_read(SOLVABLE_SUMMARY);
+    }
+    filter_dataiterator_internal(
+        p_impl->sack->pImpl->get_query_workers(),
+        pool,
+        SOLVABLE_SUMMARY,
+        p_impl->query_result,
+        cmp_type,
+        patterns,
+        p_impl->num_workers);
 
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_url(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_url", cmp_type);
     Pool * pool = p_impl->sack->pImpl->get_pool();
 
-    filter_dataiterator_internal(pool, SOLVABLE_URL, p_impl->query_result, cmp_type, patterns);
+    if (p_impl->num_workers > 1) {
+        p_impl->sack->pImpl->prepare_parallel_read(SOLVABLE_URL);
+    }
+    filter_dataiterator_internal(
+        p_impl->sack->pImpl->get_query_workers(),
+        pool,
+        SOLVABLE_URL,
+        p_impl->query_result,
+        cmp_type,
+        patterns,
+        p_impl->num_workers);
 
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_location(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_location", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -1129,6 +1489,7 @@ SolvQuery & SolvQuery::ifilter_location(libdnf::sack::QueryCmp cmp_type, const s
 }
 
 SolvQuery & SolvQuery::ifilter_provides(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_provides", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -1185,6 +1546,7 @@ static void str2reldep_internal(
 }
 
 SolvQuery & SolvQuery::ifilter_provides(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_provides", cmp_type);
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
     if (cmp_not) {
         // Removal of NOT CmpType makes following comparissons easier and effective
@@ -1206,6 +1568,7 @@ void SolvQuery::Impl::filter_provides(
     Pool * pool, libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list, solv::SolvMap & filter_result) {
     switch (cmp_type) {
         case libdnf::sack::QueryCmp::EQ: {
+            mark_indexed();
             Id p;
             Id pp;
             auto reldep_list_size = reldep_list.size();
@@ -1256,27 +1619,29 @@ void SolvQuery::Impl::filter_reldep(Id libsolv_key, libdnf::sack::QueryCmp cmp_t
 
     sack->pImpl->make_provides_ready();
 
-    solv::IdQueue rco;
+    auto reldep_list_size = reldep_list.size();
 
-    for (PackageId candidate_id : query_result) {
-        Solvable * solvable = solv::get_solvable(pool, candidate_id);
-        auto reldep_list_size = reldep_list.size();
-        for (int index = 0; index < reldep_list_size; ++index) {
-            Id reldep_filter_id = reldep_list.get_id(index).id;
+    filter_parallel(sack->pImpl->get_query_workers(), num_workers, query_result, [&](Id begin_id, Id end_id) {
+        solv::IdQueue rco;
+        for_each_candidate(query_result, begin_id, end_id, [&](PackageId candidate_id) {
+            Solvable * solvable = solv::get_solvable(pool, candidate_id);
+            for (int index = 0; index < reldep_list_size; ++index) {
+                Id reldep_filter_id = reldep_list.get_id(index).id;
 
-            rco.clear();
-            solvable_lookup_idarray(solvable, libsolv_key, &rco.get_queue());
-            auto rco_size = rco.size();
-            for (int index_j = 0; index_j < rco_size; ++index_j) {
-                Id reldep_id_from_solvable = rco[index_j];
+                rco.clear();
+                solvable_lookup_idarray(solvable, libsolv_key, &rco.get_queue());
+                auto rco_size = rco.size();
+                for (int index_j = 0; index_j < rco_size; ++index_j) {
+                    Id reldep_id_from_solvable = rco[index_j];
 
-                if (pool_match_dep(pool, reldep_filter_id, reldep_id_from_solvable) != 0) {
-                    filter_result.add_unsafe(candidate_id);
-                    break;
+                    if (pool_match_dep(pool, reldep_filter_id, reldep_id_from_solvable) != 0) {
+                        filter_result.add_unsafe(candidate_id);
+                        break;
+                    }
                 }
             }
-        }
-    }
+        });
+    });
 
     // Apply filter results to query
     if (cmp_not) {
@@ -1375,21 +1740,29 @@ void SolvQuery::Impl::filter_nevra(
 
     Id src = with_src ? 0 : pool_str2id(pool, "src", 0);
 
+    auto & solvables_evr = sack->pImpl->get_solvables_evr();
+    Stringpool * evr_strings = sack->pImpl->get_evr_strings();
+
     if (!name.empty()) {
         auto & sorted_solvables = sack->pImpl->get_sorted_solvables();
 
         switch (name_cmp_type) {
             case libdnf::sack::QueryCmp::EQ: {
+                mark_indexed();
                 Id name_id = pool_str2id(pool, name_c_pattern, 0);
                 if (name_id == 0) {
                     break;
                 }
-                auto low =
-                    std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), name_id, name_compare_lower_id);
-                while (low != sorted_solvables.end() && (*low)->name == name_id) {
-                    auto candidate_id = solv::get_package_id(pool, *low);
+                auto low = std::lower_bound(
+                    sorted_solvables.begin(), sorted_solvables.end(), name_id, [pool](PackageId id, Id name_id) {
+                        return name_compare_lower_id(solv::get_solvable(pool, id), name_id);
+                    });
+                while (low != sorted_solvables.end() && solv::get_solvable(pool, *low)->name == name_id) {
+                    auto candidate_id = *low;
                     if (!is_valid_candidate(
                             pool,
+                            evr_strings,
+                            solvables_evr[static_cast<size_t>(candidate_id.id)],
                             candidate_id,
                             src,
                             test_epoch,
@@ -1419,6 +1792,8 @@ void SolvQuery::Impl::filter_nevra(
                     }
                     if (!is_valid_candidate(
                             pool,
+                            evr_strings,
+                            solvables_evr[static_cast<size_t>(candidate_id.id)],
                             candidate_id,
                             src,
                             test_epoch,
@@ -1449,6 +1824,8 @@ void SolvQuery::Impl::filter_nevra(
 
                     if (!is_valid_candidate(
                             pool,
+                            evr_strings,
+                            solvables_evr[static_cast<size_t>(candidate_id.id)],
                             candidate_id,
                             src,
                             test_epoch,
@@ -1475,6 +1852,8 @@ void SolvQuery::Impl::filter_nevra(
         for (PackageId candidate_id : query_result) {
             if (!is_valid_candidate(
                     pool,
+                    evr_strings,
+                    solvables_evr[static_cast<size_t>(candidate_id.id)],
                     candidate_id,
                     src,
                     test_epoch,
@@ -1498,7 +1877,7 @@ void SolvQuery::Impl::filter_nevra(
 
 void SolvQuery::Impl::filter_nevra(
     Pool * pool,
-    const std::vector<Solvable *> sorted_solvables,
+    const std::vector<PackageId> & sorted_solvables,
     const std::string & pattern,
     bool cmp_glob,
     libdnf::sack::QueryCmp cmp_type,
@@ -1512,28 +1891,38 @@ void SolvQuery::Impl::filter_nevra(
 
     switch (tmp_cmp_type) {
         case libdnf::sack::QueryCmp::EQ: {
+            mark_indexed();
             NevraID nevra_id;
             if (!nevra_id.parse(pool, c_pattern, true)) {
                 return;
             }
-            auto low =
-                std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), nevra_id, nevra_compare_lower_id);
-            while (low != sorted_solvables.end() && (*low)->name == nevra_id.name && (*low)->arch == nevra_id.arch &&
-                   (*low)->evr == nevra_id.evr) {
-                filter_result.add_unsafe(solv::get_package_id(pool, *low));
-                ++low;
+            auto cmp = [pool](PackageId id, const NevraID & nevra_id) {
+                return nevra_compare_lower_id(solv::get_solvable(pool, id), nevra_id);
+            };
+            auto low = std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), nevra_id, cmp);
+            for (; low != sorted_solvables.end(); ++low) {
+                Solvable * solvable = solv::get_solvable(pool, *low);
+                if (solvable->name != nevra_id.name || solvable->arch != nevra_id.arch ||
+                    solvable->evr != nevra_id.evr) {
+                    break;
+                }
+                filter_result.add_unsafe(*low);
             }
         } break;
         case libdnf::sack::QueryCmp::GT:
+            mark_indexed();
             filter_nevra_internal<cmp_gt>(pool, c_pattern, sorted_solvables, filter_result);
             break;
         case libdnf::sack::QueryCmp::LT:
+            mark_indexed();
             filter_nevra_internal<cmp_lt>(pool, c_pattern, sorted_solvables, filter_result);
             break;
         case libdnf::sack::QueryCmp::GTE:
+            mark_indexed();
             filter_nevra_internal<cmp_gte>(pool, c_pattern, sorted_solvables, filter_result);
             break;
         case libdnf::sack::QueryCmp::LTE:
+            mark_indexed();
             filter_nevra_internal<cmp_lte>(pool, c_pattern, sorted_solvables, filter_result);
             break;
         case libdnf::sack::QueryCmp::GLOB:
@@ -1556,47 +1945,56 @@ void SolvQuery::Impl::filter_nevra(
 }
 
 SolvQuery & SolvQuery::ifilter_conflicts(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_conflicts", cmp_type);
     p_impl->filter_reldep(SOLVABLE_CONFLICTS, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_conflicts(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_conflicts", cmp_type);
     p_impl->filter_reldep(SOLVABLE_CONFLICTS, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_conflicts(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_conflicts", cmp_type);
     p_impl->filter_reldep(SOLVABLE_CONFLICTS, cmp_type, package_set);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_enhances(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_enhances", cmp_type);
     p_impl->filter_reldep(SOLVABLE_ENHANCES, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_enhances(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_enhances", cmp_type);
     p_impl->filter_reldep(SOLVABLE_ENHANCES, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_enhances(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_enhances", cmp_type);
     p_impl->filter_reldep(SOLVABLE_ENHANCES, cmp_type, package_set);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_obsoletes(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_obsoletes", cmp_type);
     p_impl->filter_reldep(SOLVABLE_OBSOLETES, cmp_type, reldep_list);
 
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_obsoletes(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_obsoletes", cmp_type);
     p_impl->filter_reldep(SOLVABLE_OBSOLETES, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_obsoletes(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_obsoletes", cmp_type);
     bool cmp_not;
     switch (cmp_type) {
         case libdnf::sack::QueryCmp::EQ:
@@ -1652,65 +2050,91 @@ SolvQuery & SolvQuery::ifilter_obsoletes(libdnf::sack::QueryCmp cmp_type, const
 }
 
 SolvQuery & SolvQuery::ifilter_recommends(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_recommends", cmp_type);
     p_impl->filter_reldep(SOLVABLE_RECOMMENDS, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_recommends(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_recommends", cmp_type);
     p_impl->filter_reldep(SOLVABLE_RECOMMENDS, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_recommends(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_recommends", cmp_type);
     p_impl->filter_reldep(SOLVABLE_RECOMMENDS, cmp_type, package_set);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_requires(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_requires", cmp_type);
     p_impl->filter_reldep(SOLVABLE_REQUIRES, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_requires(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_requires", cmp_type);
     p_impl->filter_reldep(SOLVABLE_REQUIRES, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_requires(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_requires", cmp_type);
     p_impl->filter_reldep(SOLVABLE_REQUIRES, cmp_type, package_set);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_suggests(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_suggests", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUGGESTS, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_suggests(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_suggests", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUGGESTS, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_suggests(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_suggests", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUGGESTS, cmp_type, package_set);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_supplements(libdnf::sack::QueryCmp cmp_type, const ReldepList & reldep_list) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_supplements", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUPPLEMENTS, cmp_type, reldep_list);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_supplements(libdnf::sack::QueryCmp cmp_type, const std::vector<std::string> & patterns) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_supplements", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUPPLEMENTS, cmp_type, patterns);
     return *this;
 }
 
 SolvQuery & SolvQuery::ifilter_supplements(libdnf::sack::QueryCmp cmp_type, const PackageSet & package_set) {
+    Impl::FilterProfiler profiler(*p_impl, "ifilter_supplements", cmp_type);
     p_impl->filter_reldep(SOLVABLE_SUPPLEMENTS, cmp_type, package_set);
     return *this;
 }
 
+void SolvQuery::set_num_workers(unsigned int num_workers) noexcept {
+    // more threads than the hardware can run concurrently only add the scheduling overhead
+    auto max_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    p_impl->num_workers = std::clamp(num_workers, 1u, max_workers);
+}
+
+void SolvQuery::set_profiling(bool enable) noexcept {
+    p_impl->profiling = enable;
+}
+
+const std::vector<SolvQuery::FilterStats> & SolvQuery::explain() const noexcept {
+    return p_impl->filter_stats;
+}
+
 std::size_t SolvQuery::size() const noexcept {
     return p_impl->query_result.size();
 }
@@ -1723,6 +2147,8 @@ std::pair<bool, libdnf::rpm::Nevra> SolvQuery::resolve_pkg_spec(
     bool with_filenames,
     bool with_src,
     const std::vector<libdnf::rpm::Nevra::Form> & forms) {
+    Impl::FilterProfiler profiler(
+        *p_impl, "resolve_pkg_spec", icase ? libdnf::sack::QueryCmp::IGLOB : libdnf::sack::QueryCmp::GLOB);
     SolvSack * sack = p_impl->sack.get();
     Pool * pool = sack->pImpl->get_pool();
     solv::SolvMap filter_result(sack->pImpl->get_nsolvables());
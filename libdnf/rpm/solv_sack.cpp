@@ -24,6 +24,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "solv/id_queue.hpp"
 
 #include "libdnf/rpm/repo.hpp"
+#include "libdnf/utils/decompress.hpp"
 
 extern "C" {
 #include <solv/chksum.h>
@@ -35,14 +36,23 @@ extern "C" {
 #include <solv/repo_solv.h>
 #include <solv/repo_updateinfoxml.h>
 #include <solv/repo_write.h>
-#include <solv/solv_xfopen.h>
 #include <solv/solver.h>
 #include <solv/testcase.h>
 }
 
+#include <fcntl.h>
 #include <fmt/format.h>
-
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <filesystem>
+#include <functional>
+#include <thread>
 
 
 using LibsolvRepo = Repo;
@@ -61,9 +71,23 @@ constexpr const char * SOLV_EXT_UPDATEINFO = "-updateinfo";
 constexpr const char * SOLV_EXT_PRESTO = "-presto";
 constexpr const char * SOLV_EXT_OTHER = "-other";
 
+// Suffix of the file name of the stored stat data and checksum of repomd
+constexpr const char * REPOMD_STAT_SUFFIX = "-repomd.stat";
+
 constexpr auto CHKSUM_TYPE = REPOKEY_TYPE_SHA256;
 constexpr const char * CHKSUM_IDENT = "H000";
 
+// Identification of the format of the repomd stat files
+constexpr const char * REPOMD_STAT_IDENT = "S000";
+
+// Identification of the format of the sack snapshot files
+constexpr const char * SNAPSHOT_IDENT = "P000";
+
+// The zstd compressed solv cache files consist of independent frames, they are decompressed in parallel
+constexpr size_t SOLV_ZSTD_FRAME_SIZE = 4 * 1024 * 1024;
+constexpr int SOLV_ZSTD_LEVEL = 1;
+constexpr unsigned char ZSTD_MAGIC[] = {0x28, 0xB5, 0x2F, 0xFD};
+
 // Computes checksum of data in opened file.
 // Calls rewind(fp) before returning.
 void checksum_fp(unsigned char * out, FILE * fp) {
@@ -104,11 +128,308 @@ bool can_use_repomd_cache(FILE * fp_solv, unsigned char cs_repomd[CHKSUM_BYTES])
     return fp_solv && checksum_read(cs_cache, fp_solv) && memcmp(cs_cache, cs_repomd, CHKSUM_BYTES) == 0;
 }
 
+// Paths of the rpmdb files of the supported rpmdb backends (sqlite, bdb) relative to the installroot
+constexpr const char * RPMDB_PATHS[] = {
+    "var/lib/rpm/rpmdb.sqlite",
+    "var/lib/rpm/Packages",
+    "usr/lib/sysimage/rpm/rpmdb.sqlite",
+    "usr/lib/sysimage/rpm/Packages"};
+
+void checksum_add_stat(Chksum * h, const struct stat & st) {
+    solv_chksum_add(h, &st.st_dev, sizeof(st.st_dev));
+    solv_chksum_add(h, &st.st_ino, sizeof(st.st_ino));
+    solv_chksum_add(h, &st.st_size, sizeof(st.st_size));
+    solv_chksum_add(h, &st.st_mtim.tv_sec, sizeof(st.st_mtim.tv_sec));
+    solv_chksum_add(h, &st.st_mtim.tv_nsec, sizeof(st.st_mtim.tv_nsec));
+}
+
+// Computes checksum of the current state of rpmdb in the installroot. The rpmdb is not read, the checksum covers
+// the device, inode, size and modification time of the rpmdb file. Returns false if no rpmdb file was found.
+// @replaces libdnf/dnf-sack.cpp:method:current_rpmdb_checksum()
+bool rpmdb_checksum(const std::filesystem::path & installroot, unsigned char out[CHKSUM_BYTES]) {
+    for (auto rpmdb_path : RPMDB_PATHS) {
+        auto path = installroot / rpmdb_path;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        auto h = solv_chksum_create(CHKSUM_TYPE);
+        solv_chksum_add(h, CHKSUM_IDENT, strlen(CHKSUM_IDENT));
+        checksum_add_stat(h, st);
+        // sqlite keeps changes that are not checkpointed yet in the write-ahead log
+        path += "-wal";
+        if (stat(path.c_str(), &st) == 0) {
+            checksum_add_stat(h, st);
+        }
+        solv_chksum_free(h, out);
+        return true;
+    }
+    return false;
+}
+
 // Deleter for std::unique_ptr<FILE>
 void close_file(std::FILE * fp) {
     std::fclose(fp);
 }
 
+// Stat data of a metadata file. The file is considered unchanged while they are the same.
+struct FileStat {
+    uint64_t dev{0};
+    uint64_t ino{0};
+    uint64_t size{0};
+    uint64_t mtime_ns{0};
+};
+
+FileStat file_stat(const struct stat & st) {
+    FileStat result;
+    result.dev = static_cast<uint64_t>(st.st_dev);
+    result.ino = static_cast<uint64_t>(st.st_ino);
+    result.size = static_cast<uint64_t>(st.st_size);
+    result.mtime_ns = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+    return result;
+}
+
+// Reads checksum of the repomd file from the stat file. Returns false if the stat file is missing, damaged
+// or it was written for a different version (stat data) of the repomd file.
+bool repomd_stat_read(const std::string & fn_stat, const FileStat & repomd_stat, unsigned char out[CHKSUM_BYTES]) {
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp(fopen(fn_stat.c_str(), "rb"), &close_file);
+    char ident[4];
+    FileStat stored_stat;
+    return fp && fread(ident, sizeof(ident), 1, fp.get()) == 1 &&
+           memcmp(ident, REPOMD_STAT_IDENT, sizeof(ident)) == 0 &&
+           fread(&stored_stat, sizeof(stored_stat), 1, fp.get()) == 1 &&
+           memcmp(&stored_stat, &repomd_stat, sizeof(FileStat)) == 0 && fread(out, CHKSUM_BYTES, 1, fp.get()) == 1;
+}
+
+// Stores stat data and checksum of the repomd file into the stat file.
+// The file is replaced atomically, a failure is not reported, the checksum is only computed again next time.
+void repomd_stat_write(
+    const std::string & fn_stat, const FileStat & repomd_stat, const unsigned char cs[CHKSUM_BYTES]) {
+    auto tmp_fn_templ = fn_stat + ".XXXXXX";
+    int tmp_fd = mkstemp(tmp_fn_templ.data());
+    if (tmp_fd == -1) {
+        return;
+    }
+    auto fp = fdopen(tmp_fd, "w");
+    if (!fp) {
+        close(tmp_fd);
+        unlink(tmp_fn_templ.c_str());
+        return;
+    }
+    bool ok = fwrite(REPOMD_STAT_IDENT, strlen(REPOMD_STAT_IDENT), 1, fp) == 1 &&
+              fwrite(&repomd_stat, sizeof(repomd_stat), 1, fp) == 1 && fwrite(cs, CHKSUM_BYTES, 1, fp) == 1;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmp_fn_templ.c_str(), fn_stat.c_str()) != 0) {
+        unlink(tmp_fn_templ.c_str());
+    }
+}
+
+// Computes checksum of the repomd file. The repomd file is read only if its stat data differ from the ones
+// stored in the `fn_stat` file together with the checksum. With `store_stat` the stat file is updated then.
+void repomd_checksum(
+    const char * fn_repomd, const std::string & fn_stat, bool store_stat, unsigned char out[CHKSUM_BYTES]) {
+    struct stat st;
+    if (stat(fn_repomd, &st) != 0) {
+        throw SystemError(errno, fn_repomd);
+    }
+    if (repomd_stat_read(fn_stat, file_stat(st), out)) {
+        return;
+    }
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp_repomd(fopen(fn_repomd, "rb"), &close_file);
+    if (!fp_repomd) {
+        throw SystemError(errno, fn_repomd);
+    }
+    // the stat data of the opened file, the file could be replaced in the meantime
+    if (fstat(fileno(fp_repomd.get()), &st) != 0) {
+        throw SystemError(errno, fn_repomd);
+    }
+    checksum_fp(out, fp_repomd.get());
+    if (store_stat) {
+        repomd_stat_write(fn_stat, file_stat(st), out);
+    }
+}
+
+// Writes solv data produced by `write_data` into `fp`. With `compress` the data are stored as zstd frames.
+// The checksum appended by checksum_write() stays uncompressed, the validity of the cache is checked without
+// decompression. Returns non-zero value on failure.
+int write_solv_data(std::FILE * fp, bool compress, const std::function<int(std::FILE *)> & write_data) {
+    if (!compress) {
+        return write_data(fp);
+    }
+    char * raw_data{nullptr};
+    size_t raw_size{0};
+    auto raw_fp = open_memstream(&raw_data, &raw_size);
+    if (!raw_fp) {
+        return 1;
+    }
+    std::unique_ptr<char, decltype(&free)> raw_guard(nullptr, &free);
+    int ret = write_data(raw_fp);
+    ret |= fclose(raw_fp);
+    raw_guard.reset(raw_data);
+    std::vector<char> frame(ZSTD_compressBound(SOLV_ZSTD_FRAME_SIZE));
+    for (size_t offset = 0; ret == 0 && offset < raw_size; offset += SOLV_ZSTD_FRAME_SIZE) {
+        auto len = ZSTD_compress(
+            frame.data(),
+            frame.size(),
+            raw_data + offset,
+            std::min(SOLV_ZSTD_FRAME_SIZE, raw_size - offset),
+            SOLV_ZSTD_LEVEL);
+        if (ZSTD_isError(len) || fwrite(frame.data(), len, 1, fp) != 1) {
+            ret = 1;
+        }
+    }
+    return ret;
+}
+
+// Creates anonymous memory file, a temporary file is used if memfd_create() is not supported.
+// Returns its file descriptor or -1 on failure.
+int create_memory_file(const char * name) {
+    int fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd == -1) {
+        if (auto fp = tmpfile()) {
+            fd = fcntl(fileno(fp), F_DUPFD_CLOEXEC, 0);
+            fclose(fp);
+        }
+    }
+    return fd;
+}
+
+// Memory mapping of a file, unmapped when the object is destroyed
+class FileMapping {
+public:
+    FileMapping(int fd, size_t size, int prot) : size(size), data(mmap(nullptr, size, prot, MAP_SHARED, fd, 0)) {}
+    FileMapping(const FileMapping &) = delete;
+    FileMapping & operator=(const FileMapping &) = delete;
+    ~FileMapping() {
+        if (data != MAP_FAILED) {
+            munmap(data, size);
+        }
+    }
+
+    char * get() const { return data == MAP_FAILED ? nullptr : static_cast<char *>(data); }
+
+private:
+    size_t size;
+    void * data;
+};
+
+// Decompresses zstd compressed solv cache file into an anonymous memory file, the frames are decompressed
+// in parallel. The compressed file is mapped (read through the page cache) and the frames are decompressed
+// directly into the mapped memory file, no other copy of the data is made. The memory file has a file
+// descriptor, libsolv can page the data from it. Returns nullptr if the file is damaged.
+std::FILE * decompress_solv_file(std::FILE * fp) {
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0 || st.st_size < static_cast<off_t>(CHKSUM_BYTES)) {
+        return nullptr;
+    }
+    auto file_size = static_cast<size_t>(st.st_size);
+    FileMapping compressed(fileno(fp), file_size, PROT_READ);
+    if (!compressed.get()) {
+        return nullptr;
+    }
+
+    struct Frame {
+        size_t src_offset;
+        size_t src_size;
+        size_t dst_offset;
+        size_t dst_size;
+    };
+    std::vector<Frame> frames;
+    size_t compressed_size = file_size - CHKSUM_BYTES;
+    size_t decompressed_size = 0;
+    for (size_t offset = 0; offset < compressed_size;) {
+        auto src_size = ZSTD_findFrameCompressedSize(compressed.get() + offset, compressed_size - offset);
+        auto dst_size = ZSTD_getFrameContentSize(compressed.get() + offset, compressed_size - offset);
+        if (ZSTD_isError(src_size) || dst_size == ZSTD_CONTENTSIZE_UNKNOWN || dst_size == ZSTD_CONTENTSIZE_ERROR) {
+            return nullptr;
+        }
+        frames.push_back({offset, src_size, decompressed_size, dst_size});
+        offset += src_size;
+        decompressed_size += dst_size;
+    }
+
+    int fd = create_memory_file("libdnf-solv");
+    if (fd == -1) {
+        return nullptr;
+    }
+    std::FILE * memory_fp = fdopen(fd, "rb");
+    if (!memory_fp) {
+        close(fd);
+        return nullptr;
+    }
+    std::unique_ptr<std::FILE, decltype(&close_file)> memory_guard(memory_fp, &close_file);
+    auto memory_size = decompressed_size + CHKSUM_BYTES;
+    if (ftruncate(fd, static_cast<off_t>(memory_size)) != 0) {
+        return nullptr;
+    }
+    FileMapping decompressed(fd, memory_size, PROT_READ | PROT_WRITE);
+    if (!decompressed.get()) {
+        return nullptr;
+    }
+
+    std::atomic<bool> failed{false};
+    auto decompress_frames = [&](size_t first, size_t step) {
+        for (size_t idx = first; idx < frames.size() && !failed; idx += step) {
+            auto & frame = frames[idx];
+            auto len = ZSTD_decompress(
+                decompressed.get() + frame.dst_offset,
+                frame.dst_size,
+                compressed.get() + frame.src_offset,
+                frame.src_size);
+            if (ZSTD_isError(len) || len != frame.dst_size) {
+                failed = true;
+            }
+        }
+    };
+    size_t nthreads = std::min(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)), frames.size());
+    std::vector<std::thread> threads;
+    for (size_t idx = 1; idx < nthreads; ++idx) {
+        threads.emplace_back(decompress_frames, idx, nthreads);
+    }
+    decompress_frames(0, std::max(nthreads, size_t{1}));
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    if (failed) {
+        return nullptr;
+    }
+    memcpy(decompressed.get() + decompressed_size, compressed.get() + compressed_size, CHKSUM_BYTES);
+    return memory_guard.release();
+}
+
+// Opens solv cache file. The checksum of a compressed file is stored uncompressed, the validity of the cache
+// is checked by can_use_repomd_cache() on the opened file without decompression. The data must be prepared
+// by prepare_solv_data() before they are loaded by repo_add_solv().
+// The incore part of the file is read sequentially during the loading, the kernel is advised to read ahead.
+std::FILE * open_solv_file(const char * fn) {
+    auto fp = fopen(fn, "rb");
+    if (fp) {
+        posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    return fp;
+}
+
+// Prepares solv cache file opened by open_solv_file() for loading by repo_add_solv(). A zstd compressed file
+// is replaced by an anonymous memory file with the decompressed data. Returns false (and resets `fp`) if
+// the file is damaged.
+bool prepare_solv_data(std::unique_ptr<std::FILE, decltype(&close_file)> & fp) {
+    unsigned char magic[sizeof(ZSTD_MAGIC)];
+    bool compressed = fread(magic, sizeof(magic), 1, fp.get()) == 1 && memcmp(magic, ZSTD_MAGIC, sizeof(magic)) == 0;
+    rewind(fp.get());
+    if (compressed) {
+        fp.reset(decompress_solv_file(fp.get()));
+    }
+    return fp != nullptr;
+}
+
+// Libsolv does not copy the paged (vertical) data of a loaded solv file (descriptions, file lists, ...) to memory.
+// It keeps a duplicate of the file descriptor and reads the pages on demand through the page cache, which
+// is shared by all processes using the same cache file. The pages are accessed randomly, read ahead is not wanted.
+// The advice belongs to the open file description, so it also applies to the libsolv duplicate.
+void advise_paged_access(std::FILE * fp) {
+    posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_RANDOM);
+}
+
 // Deleter for std::unique_ptr<LibsolvRepo>
 void libsolv_repo_free(LibsolvRepo * libsolv_repo) {
     repo_free(libsolv_repo, 1);
@@ -134,13 +455,72 @@ int is_superset(const solv::IdQueue & q1, const solv::IdQueue * q2, solv::SolvMa
     return cnt == q2->size();
 }
 
+// Memory used by a libsolv string pool
+std::size_t stringpool_memory(const Stringpool & ss) {
+    std::size_t size = static_cast<std::size_t>(ss.nstrings) * sizeof(Offset) + ss.sstrings;
+    if (ss.stringhashtbl) {
+        size += (static_cast<std::size_t>(ss.stringhashmask) + 1) * sizeof(Id);
+    }
+    return size;
+}
+
+// Memory used by a repodata (without its local string pool)
+std::size_t repodata_memory(Repodata * data) {
+    std::size_t size = repodata_memused(data);
+    size += static_cast<std::size_t>(data->nkeys) * sizeof(Repokey);
+    size += static_cast<std::size_t>(data->nschemata) * sizeof(Id);
+    size += static_cast<std::size_t>(data->dirpool.ndirs) * sizeof(Id) * (data->dirpool.dirtraverse ? 2 : 1);
+    return size;
+}
+
 }  // end of anonymous namespace
 
+const SolvSack::Impl::RepodataExtension SolvSack::Impl::REPODATA_EXTENSIONS[4] = {
+    // do not pollute the main pool with directory component ids flags |= REPO_LOCALPOOL
+    {LoadRepoFlags::USE_FILELISTS,
+     RepodataType::FILENAMES,
+     SOLV_EXT_FILENAMES,
+     Repo::Impl::MD_FILENAME_FILELISTS,
+     REPO_EXTEND_SOLVABLES | REPO_LOCALPOOL,
+     SOLVABLE_FILELIST,
+     REPOKEY_TYPE_DIRSTRARRAY,
+     [](LibsolvRepo * repo, FILE * fp, int flags) {
+         return repo_add_rpmmd(repo, fp, "FL", REPO_EXTEND_SOLVABLES | flags) == 0;
+     }},
+    {LoadRepoFlags::USE_OTHER,
+     RepodataType::OTHER,
+     SOLV_EXT_OTHER,
+     Repo::Impl::MD_FILENAME_OTHER,
+     REPO_EXTEND_SOLVABLES | REPO_LOCALPOOL,
+     SOLVABLE_CHANGELOG,
+     REPOKEY_TYPE_FLEXARRAY,
+     [](LibsolvRepo * repo, FILE * fp, int flags) {
+         return repo_add_rpmmd(repo, fp, 0, REPO_EXTEND_SOLVABLES | flags) == 0;
+     }},
+    {LoadRepoFlags::USE_PRESTO,
+     RepodataType::PRESTO,
+     SOLV_EXT_PRESTO,
+     Repo::Impl::MD_FILENAME_PRESTODELTA,
+     REPO_EXTEND_SOLVABLES,
+     REPOSITORY_DELTAINFO,
+     REPOKEY_TYPE_FLEXARRAY,
+     [](LibsolvRepo * repo, FILE * fp, int flags) { return repo_add_deltainfoxml(repo, fp, flags) == 0; }},
+    // the updateinfo is not a real extension flags = 0
+    {LoadRepoFlags::USE_UPDATEINFO,
+     RepodataType::UPDATEINFO,
+     SOLV_EXT_UPDATEINFO,
+     Repo::Impl::MD_FILENAME_UPDATEINFO,
+     0,
+     0,
+     0,
+     [](LibsolvRepo * repo, FILE * fp, int flags) { return repo_add_updateinfoxml(repo, fp, flags) == 0; }},
+};
+
 void SolvSack::Impl::write_main(LibsolvRepoExt & libsolv_repo_ext, bool switchtosolv) {
     auto & logger = base->get_logger();
     LibsolvRepo * libsolv_repo = libsolv_repo_ext.repo;
     const char * name = libsolv_repo->name;
-    const char * chksum = pool_bin2hex(pool, libsolv_repo_ext.checksum, solv_chksum_len(CHKSUM_TYPE));
+    const char * chksum = pool_bin2hex(libsolv_repo->pool, libsolv_repo_ext.checksum, solv_chksum_len(CHKSUM_TYPE));
     auto fn = give_repo_solv_cache_fn(name, NULL);
     auto tmp_fn_templ = fn + ".XXXXXX";
     int tmp_fd = mkstemp(tmp_fn_templ.data());
@@ -160,7 +540,9 @@ void SolvSack::Impl::write_main(LibsolvRepoExt & libsolv_repo_ext, bool switchto
         throw SystemError(tmp_err, _("failed opening tmp file"));
         // g_set_error (error, DNF_ERROR, DNF_ERROR_FILE_INVALID, _("failed opening tmp file: %s"), strerror(errno));
     }
-    int ret = repo_write(libsolv_repo, fp);
+    int ret = write_solv_data(fp, compress_solv_cache(), [libsolv_repo](std::FILE * data_fp) {
+        return repo_write(libsolv_repo, data_fp);
+    });
     ret |= checksum_write(libsolv_repo_ext.checksum, fp);
     ret |= fclose(fp);
     if (ret) {
@@ -170,8 +552,8 @@ void SolvSack::Impl::write_main(LibsolvRepoExt & libsolv_repo_ext, bool switchto
     }
     if (switchtosolv && libsolv_repo_ext.is_one_piece()) {
         /* switch over to written solv file activate paging */
-        std::unique_ptr<std::FILE, decltype(&close_file)> fp(fopen(tmp_fn_templ.c_str(), "r"), &close_file);
-        if (fp) {
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp(open_solv_file(tmp_fn_templ.c_str()), &close_file);
+        if (fp && prepare_solv_data(fp)) {
             repo_empty(libsolv_repo, 1);
             int ret = repo_add_solv(libsolv_repo, fp.get(), 0);
             if (ret) {
@@ -179,6 +561,7 @@ void SolvSack::Impl::write_main(LibsolvRepoExt & libsolv_repo_ext, bool switchto
                 throw Exception(_("write_main() failed to re-load written solv file"));
                 // g_set_error_literal (error, DNF_ERROR, DNF_ERROR_FILE_INVALID, _("write_main() failed to re-load " "written solv file"));
             }
+            advise_paged_access(fp.get());
         }
     }
 
@@ -199,7 +582,11 @@ static int write_ext_updateinfo_filter(LibsolvRepo * repo, Repokey * key, void *
 }
 
 void SolvSack::Impl::write_ext(
-    LibsolvRepoExt & libsolv_repo_ext, Id repodata_id, RepodataType which_repodata, const char * suffix) {
+    LibsolvRepoExt & libsolv_repo_ext,
+    Id repodata_id,
+    RepodataType which_repodata,
+    const char * suffix,
+    bool switchtosolv) {
     auto & logger = base->get_logger();
     auto libsolv_repo = libsolv_repo_ext.repo;
     const char * repo_id = libsolv_repo->name;
@@ -218,18 +605,19 @@ void SolvSack::Impl::write_ext(
     auto fp = fdopen(tmp_fd, "w+");
 
     logger.debug(fmt::format("{}: storing {} to: {}", __func__, repo_id, tmp_fn_templ));
-    int ret;
-    if (which_repodata != RepodataType::UPDATEINFO)
-        ret = repodata_write(data, fp);
-    else {
+    int ret = write_solv_data(fp, compress_solv_cache(), [&](std::FILE * data_fp) {
+        if (which_repodata != RepodataType::UPDATEINFO) {
+            return repodata_write(data, data_fp);
+        }
         // block replaces: ret = write_ext_updateinfo(hrepo, data, fp);
         auto oldstart = libsolv_repo->start;
         libsolv_repo->start = libsolv_repo_ext.main_end;
         libsolv_repo->nsolvables -= libsolv_repo_ext.main_nsolvables;
-        ret = repo_write_filtered(libsolv_repo, fp, write_ext_updateinfo_filter, data, 0);
+        int write_ret = repo_write_filtered(libsolv_repo, data_fp, write_ext_updateinfo_filter, data, 0);
         libsolv_repo->start = oldstart;
         libsolv_repo->nsolvables += libsolv_repo_ext.main_nsolvables;
-    }
+        return write_ret;
+    });
     ret |= checksum_write(libsolv_repo_ext.checksum, fp);
     ret |= fclose(fp);
     if (ret) {
@@ -237,10 +625,10 @@ void SolvSack::Impl::write_ext(
         throw Exception(_("write_ext() has failed"));
         // g_set_error(error, DNF_ERROR, DNF_ERROR_FAILED, _("write_ext(%1$d) has failed: %2$d"), which_repodata, ret);
     }
-    if (libsolv_repo_ext.is_one_piece() && which_repodata != RepodataType::UPDATEINFO) {
+    if (switchtosolv && libsolv_repo_ext.is_one_piece() && which_repodata != RepodataType::UPDATEINFO) {
         // switch over to written solv file activate paging
-        std::unique_ptr<std::FILE, decltype(&close_file)> fp(fopen(tmp_fn_templ.c_str(), "r"), &close_file);
-        if (fp) {
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp(open_solv_file(tmp_fn_templ.c_str()), &close_file);
+        if (fp && prepare_solv_data(fp)) {
             int flags = REPO_USE_LOADING | REPO_EXTEND_SOLVABLES;
             // do not pollute the main pool with directory component ids
             if (which_repodata == RepodataType::FILENAMES || which_repodata == RepodataType::OTHER)
@@ -249,6 +637,7 @@ void SolvSack::Impl::write_ext(
             data->state = REPODATA_LOADING;
             repo_add_solv(libsolv_repo, fp.get(), flags);
             data->state = REPODATA_AVAILABLE;
+            advise_paged_access(fp.get());
         }
     }
 
@@ -274,7 +663,10 @@ void SolvSack::Impl::rewrite_repos(solv::IdQueue & addedfileprovides, solv::IdQu
         if (!repo) {
             continue;
         }
-        if (!(repo->get_config()->build_cache().get_value())) {
+        bool build_cache = repo->get_config()->build_cache().get_value();
+        // the repositories loaded from the shared cache are stored back with the added file provides
+        bool shared = shared_repo_cache && repo->p_impl->type == Repo::Type::AVAILABLE;
+        if (!build_cache && !shared) {
             continue;
         }
         auto & libsolv_repo_ext = repo->p_impl.get()->libsolv_repo_ext;
@@ -303,7 +695,12 @@ void SolvSack::Impl::rewrite_repos(solv::IdQueue & addedfileprovides, solv::IdQu
         libsolv_repo->nsolvables = libsolv_repo_ext.main_nsolvables;
         libsolv_repo->end = libsolv_repo_ext.main_end;
         logger.debug(fmt::format("rewriting repo: {}", libsolv_repo->name));
-        write_main(libsolv_repo_ext, false);
+        if (build_cache) {
+            write_main(libsolv_repo_ext, false);
+        }
+        if (shared) {
+            shared_repo_cache->p_impl->store(repo->p_impl->id, libsolv_repo_ext.checksum, libsolv_repo);
+        }
         libsolv_repo->nrepodata = oldnrepodata;
         libsolv_repo->nsolvables = oldnsolvables;
         libsolv_repo->end = oldend;
@@ -323,19 +720,32 @@ SolvSack::Impl::RepodataState SolvSack::Impl::load_repo_main(Repo & repo) {
     const char * fn_repomd = repo_impl->repomd_fn.c_str();
     auto fn_cache = give_repo_solv_cache_fn(id, nullptr);
 
-    std::unique_ptr<std::FILE, decltype(&close_file)> fp_repomd(fopen(fn_repomd, "rb"), &close_file);
-    if (!fp_repomd) {
-        throw SystemError(errno, fn_repomd);
+    repomd_checksum(
+        fn_repomd,
+        give_repomd_stat_fn(id),
+        repo.get_config()->build_cache().get_value(),
+        repo_impl->libsolv_repo_ext.checksum);
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp_shared(nullptr, &close_file);
+    if (shared_repo_cache) {
+        fp_shared.reset(shared_repo_cache->p_impl->open(id, repo_impl->libsolv_repo_ext.checksum));
     }
-    checksum_fp(repo_impl->libsolv_repo_ext.checksum, fp_repomd.get());
-    std::unique_ptr<std::FILE, decltype(&close_file)> fp_cache(fopen(fn_cache.c_str(), "rb"), &close_file);
-    if (can_use_repomd_cache(fp_cache.get(), repo_impl->libsolv_repo_ext.checksum)) {
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp_cache(
+        fp_shared ? nullptr : open_solv_file(fn_cache.c_str()), &close_file);
+    if (fp_shared) {
+        logger.debug(fmt::format("using shared data of {}", id));
+        if (repo_add_solv(libsolv_repo.get(), fp_shared.get(), 0)) {
+            throw Exception(_("repo_add_solv() has failed."));
+        }
+        data_state = RepodataState::LOADED_SHARED;
+    } else if (can_use_repomd_cache(fp_cache.get(), repo_impl->libsolv_repo_ext.checksum) &&
+               prepare_solv_data(fp_cache)) {
         //const char *chksum = pool_checksum_str(pool, repoImpl->checksum);
         //logger.debug("using cached %s (0x%s)", name, chksum);
         if (repo_add_solv(libsolv_repo.get(), fp_cache.get(), 0)) {
             throw Exception(_("repo_add_solv() has failed."));
             // g_set_error (error, DNF_ERROR, DNF_ERROR_INTERNAL_ERROR, _("repo_add_solv() has failed."));
         }
+        advise_paged_access(fp_cache.get());
         data_state = RepodataState::LOADED_CACHE;
     } else {
         auto primary = repo.get_metadata_path(Repo::Impl::MD_FILENAME_PRIMARY);
@@ -345,8 +755,12 @@ SolvSack::Impl::RepodataState SolvSack::Impl::load_repo_main(Repo & repo) {
             throw Exception(_("loading of MD_FILENAME_PRIMARY has failed."));
             // g_set_error (error, DNF_ERROR, DNF_ERROR_INTERNAL_ERROR, _("loading of MD_FILENAME_PRIMARY has failed."));
         }
-        std::unique_ptr<std::FILE, decltype(&close_file)> fp_primary(solv_xfopen(primary.c_str(), "r"), &close_file);
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp_primary(utils::open_decompressed(primary), &close_file);
         assert(fp_primary);
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp_repomd(fopen(fn_repomd, "rb"), &close_file);
+        if (!fp_repomd) {
+            throw SystemError(errno, fn_repomd);
+        }
 
         logger.debug(std::string("fetching ") + id);
         if (repo_add_repomdxml(libsolv_repo.get(), fp_repomd.get(), 0) ||
@@ -358,12 +772,12 @@ SolvSack::Impl::RepodataState SolvSack::Impl::load_repo_main(Repo & repo) {
     }
 
     repo_impl->attach_libsolv_repo(libsolv_repo.release());
-    provides_ready = false;
+    invalidate_provides();
     return data_state;
 }
 
 SolvSack::Impl::RepodataInfo SolvSack::Impl::load_repo_ext(
-    Repo & repo, const char * suffix, const char * which_filename, int flags, bool (*cb)(LibsolvRepo *, FILE *)) {
+    Repo & repo, const RepodataExtension & extension, Repodata * stub) {
     RepodataInfo info;
     auto & logger = base->get_logger();
     auto repo_impl = repo.p_impl.get();
@@ -371,27 +785,31 @@ SolvSack::Impl::RepodataInfo SolvSack::Impl::load_repo_ext(
     const char * repo_id = libsolv_repo->name;
 
     // nothing set
-    auto fn = repo.get_metadata_path(which_filename);
+    auto fn = repo.get_metadata_path(extension.md_filename);
     if (fn.empty()) {
         // g_set_error (error, DNF_ERROR, DNF_ERROR_NO_CAPABILITY, _("no %1$s string for %2$s"), which_filename, repo_id);
-        throw NoCapability(fmt::format(_("no {0} string for {1}"), which_filename, repo_id));
+        throw NoCapability(fmt::format(_("no {0} string for {1}"), extension.md_filename, repo_id));
     }
 
-    auto fn_cache = give_repo_solv_cache_fn(repo_id, suffix);
-    std::unique_ptr<std::FILE, decltype(&close_file)> fp(fopen(fn_cache.c_str(), "rb"), &close_file);
+    // data of the stub are loaded into the stub repodata itself, no new repodata is created
+    int flags = stub ? REPO_USE_LOADING : 0;
+
+    auto fn_cache = give_repo_solv_cache_fn(repo_id, extension.solv_suffix);
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp(open_solv_file(fn_cache.c_str()), &close_file);
     assert(repo_impl->libsolv_repo_ext.checksum);
-    if (can_use_repomd_cache(fp.get(), repo_impl->libsolv_repo_ext.checksum)) {
+    if (can_use_repomd_cache(fp.get(), repo_impl->libsolv_repo_ext.checksum) && prepare_solv_data(fp)) {
         logger.debug(fmt::format("{}: using cache file: {}", __func__, fn_cache));
-        if (repo_add_solv(libsolv_repo, fp.get(), flags) != 0) {
+        if (repo_add_solv(libsolv_repo, fp.get(), extension.solv_flags | flags) != 0) {
             // g_set_error_literal (error, DNF_ERROR, DNF_ERROR_INTERNAL_ERROR, _("failed to add solv"));
             throw Exception(_("repo_add_solv() has failed."));
         }
+        advise_paged_access(fp.get());
         info.state = RepodataState::LOADED_CACHE;
-        info.id = libsolv_repo->nrepodata - 1;
+        info.id = stub ? stub->repodataid : libsolv_repo->nrepodata - 1;
         return info;
     }
 
-    fp.reset(solv_xfopen(fn.c_str(), "r"));
+    fp.reset(utils::open_decompressed(fn));
     if (!fp) {
         // g_set_error (error, DNF_ERROR, DNF_ERROR_FILE_INVALID, _("failed to open: %s"), fn.c_str());
         throw Exception(fmt::format(_("failed to open: {}"), fn));
@@ -399,16 +817,77 @@ SolvSack::Impl::RepodataInfo SolvSack::Impl::load_repo_ext(
     logger.debug(fmt::format("{}: loading: {}", __func__, fn.c_str()));
 
     int previous_last = libsolv_repo->nrepodata - 1;
-    auto ok = cb(libsolv_repo, fp.get());
+    auto ok = extension.parse(libsolv_repo, fp.get(), flags);
     if (ok) {
         info.state = RepodataState::LOADED_FETCH;
-        assert(previous_last == libsolv_repo->nrepodata - 2);
-        info.id = libsolv_repo->nrepodata - 1;
+        if (stub) {
+            info.id = stub->repodataid;
+        } else {
+            assert(previous_last == libsolv_repo->nrepodata - 2);
+            info.id = libsolv_repo->nrepodata - 1;
+        }
+    }
+    // the repodata stubs are loaded on demand after the provides are created, they do not change them
+    if (!stub) {
+        invalidate_provides();
     }
-    provides_ready = false;
     return info;
 }
 
+void SolvSack::Impl::add_repodata_stubs(
+    LibsolvRepo * libsolv_repo, const std::vector<const RepodataExtension *> & extensions) {
+    Repodata * data = repo_add_repodata(libsolv_repo, 0);
+    // the stubs cover the same range of solvables as the repodata they are created from
+    repodata_extend_block(data, libsolv_repo->start, libsolv_repo->end - libsolv_repo->start);
+    for (auto extension : extensions) {
+        Id handle = repodata_new_handle(data);
+        repodata_set_poolstr(data, handle, REPOSITORY_REPOMD_TYPE, extension->md_filename);
+        repodata_add_idarray(data, handle, REPOSITORY_KEYS, extension->stub_keyname);
+        repodata_add_idarray(data, handle, REPOSITORY_KEYS, extension->stub_keytype);
+        repodata_add_flexarray(data, SOLVID_META, REPOSITORY_EXTERNAL, handle);
+    }
+    repodata_internalize(data);
+    repodata_create_stubs(data);
+}
+
+int SolvSack::Impl::repodata_stub_loader(Pool *, Repodata * stub, void * sack_impl) {
+    return static_cast<SolvSack::Impl *>(sack_impl)->load_repodata_stub(stub) ? 1 : 0;
+}
+
+bool SolvSack::Impl::load_repodata_stub(Repodata * stub) {
+    auto & logger = base->get_logger();
+    auto repo = static_cast<Repo *>(stub->repo->appdata);
+    const char * md_type = repodata_lookup_str(stub, SOLVID_META, REPOSITORY_REPOMD_TYPE);
+    if (!repo || !md_type) {
+        return false;
+    }
+    auto extension = std::find_if(
+        std::begin(REPODATA_EXTENSIONS), std::end(REPODATA_EXTENSIONS), [md_type](const RepodataExtension & ext) {
+            return strcmp(ext.md_filename, md_type) == 0;
+        });
+    if (extension == std::end(REPODATA_EXTENSIONS)) {
+        return false;
+    }
+
+    RepodataInfo repodata_info;
+    try {
+        repodata_info = load_repo_ext(*repo, *extension, stub);
+    } catch (const std::exception & ex) {
+        logger.warning(fmt::format("failed to load {} metadata of {}: {}", md_type, repo->get_id(), ex.what()));
+        return false;
+    }
+    if (repodata_info.state == RepodataState::LOADED_FETCH && repo->get_config()->build_cache().get_value()) {
+        // the stub is in the middle of a lookup, it cannot be switched over to the written cache file
+        try {
+            write_ext(
+                repo->p_impl->libsolv_repo_ext, repodata_info.id, extension->type, extension->solv_suffix, false);
+        } catch (const std::exception & ex) {
+            logger.warning(fmt::format("failed to write {} cache of {}: {}", md_type, repo->get_id(), ex.what()));
+        }
+    }
+    return repodata_info.state != RepodataState::NEW;
+}
+
 void SolvSack::Impl::internalize_libsolv_repos() {
     int i;
     LibsolvRepo * libsolv_repo;
@@ -425,6 +904,23 @@ void SolvSack::Impl::internalize_libsolv_repo(LibsolvRepo * libsolv_repo) {
     }
 }
 
+void SolvSack::Impl::prepare_parallel_read(Id keyname) {
+    internalize_libsolv_repos();
+    int i;
+    LibsolvRepo * libsolv_repo;
+    FOR_REPOS(i, libsolv_repo) {
+        for (Id repodata_id = 1; repodata_id < libsolv_repo->nrepodata; ++repodata_id) {
+            auto data = repo_id2repodata(libsolv_repo, repodata_id);
+            if (data->state == REPODATA_STUB && data->loadcallback && repodata_has_keyname(data, keyname)) {
+                data->loadcallback(data);
+            }
+            if (data->state == REPODATA_AVAILABLE && repodata_has_keyname(data, keyname)) {
+                repodata_disable_paging(data);
+            }
+        }
+    }
+}
+
 void SolvSack::Impl::make_provides_ready() {
     if (provides_ready) {
         return;
@@ -432,6 +928,9 @@ void SolvSack::Impl::make_provides_ready() {
     internalize_libsolv_repos();
     solv::IdQueue addedfileprovides;
     solv::IdQueue addedfileprovides_inst;
+    // Libsolv has no interface for adding the file provides or extending whatprovides for a part of the pool.
+    // The file dependencies of all solvables are collected on every call, the filelists of the repodata whose
+    // REPOSITORY_ADDEDFILEPROVIDES (stored in the rewritten solv caches) covers them are not searched again.
     pool_addfileprovides_queue(pool, &addedfileprovides.get_queue(), &addedfileprovides_inst.get_queue());
     if (!addedfileprovides.empty() || !addedfileprovides_inst.empty()) {
         rewrite_repos(addedfileprovides, addedfileprovides_inst);
@@ -447,18 +946,58 @@ bool SolvSack::Impl::load_system_repo() {
 
     std::unique_ptr<LibsolvRepo, decltype(&libsolv_repo_free)> libsolv_repo(repo_create(pool, id), &libsolv_repo_free);
 
-    logger.debug("load_system_repo(): fetching rpmdb");
-    int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR;
-    int rc = repo_add_rpmdb(libsolv_repo.get(), nullptr, flagsrpm);
-    if (rc != 0) {
-        // g_set_error(error, DNF_ERROR, DNF_ERROR_FILE_INVALID, _("failed loading RPMDB"));
-        logger.warning(fmt::format(_("load_system_repo(): failed loading RPMDB: {}"), pool_errstr(pool)));
-        return false;
+    // The solv cache of rpmdb is valid while the rpmdb file is not modified
+    const auto & installroot = base->get_config().installroot().get_value();
+    bool build_cache = system_repo->get_config()->build_cache().get_value() &&
+                       rpmdb_checksum(installroot, repo_impl->libsolv_repo_ext.checksum);
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp_cache(nullptr, &close_file);
+    if (build_cache) {
+        fp_cache.reset(open_solv_file(give_repo_solv_cache_fn(id).c_str()));
+        // also the outdated cache is read, it is a reference for loading of the rpmdb
+        if (fp_cache) {
+            prepare_solv_data(fp_cache);
+        }
+    }
+
+    auto state = RepodataState::NEW;
+    if (can_use_repomd_cache(fp_cache.get(), repo_impl->libsolv_repo_ext.checksum)) {
+        logger.debug("load_system_repo(): using cached rpmdb");
+        if (repo_add_solv(libsolv_repo.get(), fp_cache.get(), 0) == 0) {
+            advise_paged_access(fp_cache.get());
+            state = RepodataState::LOADED_CACHE;
+        } else {
+            logger.warning(fmt::format("load_system_repo(): failed loading rpmdb cache: {}", pool_errstr(pool)));
+            repo_empty(libsolv_repo.get(), 1);
+        }
+    }
+    if (state == RepodataState::NEW) {
+        logger.debug("load_system_repo(): fetching rpmdb");
+        int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR;
+        // the outdated cache is a reference, the data of headers that did not change are taken from it
+        if (fp_cache) {
+            rewind(fp_cache.get());
+        }
+        int rc = repo_add_rpmdb_reffp(libsolv_repo.get(), fp_cache.get(), flagsrpm);
+        if (rc != 0) {
+            // g_set_error(error, DNF_ERROR, DNF_ERROR_FILE_INVALID, _("failed loading RPMDB"));
+            logger.warning(fmt::format(_("load_system_repo(): failed loading RPMDB: {}"), pool_errstr(pool)));
+            return false;
+        }
+        state = RepodataState::LOADED_FETCH;
     }
 
     repo_impl->attach_libsolv_repo(libsolv_repo.release());
 
-    auto libsolv_repo_ext = repo_impl->libsolv_repo_ext;
+    // the system repository is usable without the cache, failure to write it is not fatal
+    if (state == RepodataState::LOADED_FETCH && build_cache) {
+        try {
+            write_main(repo_impl->libsolv_repo_ext, true);
+        } catch (const std::exception & ex) {
+            logger.warning(fmt::format("load_system_repo(): failed writing rpmdb cache: {}", ex.what()));
+        }
+    }
+
+    auto & libsolv_repo_ext = repo_impl->libsolv_repo_ext;
 
     pool_set_installed(pool, libsolv_repo_ext.repo);
 
@@ -467,14 +1006,16 @@ bool SolvSack::Impl::load_system_repo() {
     libsolv_repo_ext.main_nrepodata = libsolv_repo_ext.repo->nrepodata;
     libsolv_repo_ext.main_end = libsolv_repo_ext.repo->end;
 
-    provides_ready = false;
+    invalidate_provides();
     considered_uptodate = false;
 
+    // mark package solvables of the loaded repository, the solvables cache is updated incrementally
+    get_solvables();
+
     return true;
 }
 
 void SolvSack::Impl::load_available_repo(Repo & repo, LoadRepoFlags flags) {
-    auto & logger = base->get_logger();
     auto repo_impl = repo.p_impl.get();
 
     bool build_cache = repo.get_config()->build_cache().get_value();
@@ -485,72 +1026,506 @@ void SolvSack::Impl::load_available_repo(Repo & repo, LoadRepoFlags flags) {
     repo_impl->libsolv_repo_ext.main_nsolvables = repo_impl->libsolv_repo_ext.repo->nsolvables;
     repo_impl->libsolv_repo_ext.main_nrepodata = repo_impl->libsolv_repo_ext.repo->nrepodata;
     repo_impl->libsolv_repo_ext.main_end = repo_impl->libsolv_repo_ext.repo->end;
-    if (any(flags & LoadRepoFlags::USE_FILELISTS)) {
-        try {
-            // do not pollute the main pool with directory component ids flags |= REPO_LOCALPOOL
-            auto repodata_info = load_repo_ext(
-                repo,
-                SOLV_EXT_FILENAMES,
-                Repo::Impl::MD_FILENAME_FILELISTS,
-                REPO_EXTEND_SOLVABLES | REPO_LOCALPOOL,
-                [](LibsolvRepo * repo, FILE * fp) {
-                    return repo_add_rpmmd(repo, fp, "FL", REPO_EXTEND_SOLVABLES) == 0;
-                });
-            if (repodata_info.state == RepodataState::LOADED_FETCH && build_cache) {
-                write_ext(repo_impl->libsolv_repo_ext, repodata_info.id, RepodataType::FILENAMES, SOLV_EXT_FILENAMES);
-            }
-        } catch (const NoCapability & ex) {
-            logger.debug(fmt::format("no filelists metadata available for {}", repo_impl->id));
+    if (shared_repo_cache && state != RepodataState::LOADED_SHARED) {
+        shared_repo_cache->p_impl->store(
+            repo_impl->id, repo_impl->libsolv_repo_ext.checksum, repo_impl->libsolv_repo_ext.repo);
+    }
+    load_repo_extensions(repo, flags);
+    considered_uptodate = false;
+
+    // mark package solvables of the loaded repository, the solvables cache is updated incrementally
+    get_solvables();
+}
+
+void SolvSack::Impl::load_repo_extensions(Repo & repo, LoadRepoFlags flags) {
+    auto & logger = base->get_logger();
+    auto repo_impl = repo.p_impl.get();
+    bool build_cache = repo.get_config()->build_cache().get_value();
+    repo_impl->libsolv_repo_ext.load_flags = flags;
+    std::vector<const RepodataExtension *> stub_extensions;
+    for (auto & extension : REPODATA_EXTENSIONS) {
+        if (!any(flags & extension.load_flag)) {
+            continue;
+        }
+        if (repo.get_metadata_path(extension.md_filename).empty()) {
+            logger.debug(fmt::format("no {} metadata available for {}", extension.md_filename, repo_impl->id));
+            continue;
+        }
+        if (extension.stub_keyname) {
+            stub_extensions.push_back(&extension);
+            continue;
+        }
+        auto repodata_info = load_repo_ext(repo, extension);
+        if (repodata_info.state == RepodataState::LOADED_FETCH && build_cache) {
+            write_ext(repo_impl->libsolv_repo_ext, repodata_info.id, extension.type, extension.solv_suffix, true);
         }
     }
-    if (any(flags & LoadRepoFlags::USE_OTHER)) {
-        try {
-            // do not pollute the main pool with directory component ids flags |= REPO_LOCALPOOL
-            auto repodata_info = load_repo_ext(
-                repo,
-                SOLV_EXT_OTHER,
-                Repo::Impl::MD_FILENAME_OTHER,
-                REPO_EXTEND_SOLVABLES | REPO_LOCALPOOL,
-                [](LibsolvRepo * repo, FILE * fp) { return repo_add_rpmmd(repo, fp, 0, REPO_EXTEND_SOLVABLES) == 0; });
-            if (repodata_info.state == RepodataState::LOADED_FETCH && build_cache) {
-                write_ext(repo_impl->libsolv_repo_ext, repodata_info.id, RepodataType::OTHER, SOLV_EXT_OTHER);
+    if (!stub_extensions.empty()) {
+        add_repodata_stubs(repo_impl->libsolv_repo_ext.repo, stub_extensions);
+    }
+}
+
+void SolvSack::Impl::unload_repo(Repo & repo) {
+    auto repo_impl = repo.p_impl.get();
+    auto libsolv_repo = repo_impl->libsolv_repo_ext.repo;
+    auto forked_repo = forked_repos.find(&repo);
+    if (forked_repo != forked_repos.end()) {
+        libsolv_repo = pool_id2repo(pool, forked_repo->second);
+    } else if (libsolv_repo && libsolv_repo->pool != pool) {
+        // the repository is loaded in another sack
+        libsolv_repo = nullptr;
+    }
+    if (!libsolv_repo) {
+        throw LogicError(fmt::format("SolvSack::unload_repo(): Repository \"{}\" is not loaded", repo.get_id()));
+    }
+    base->get_logger().debug(fmt::format("unloading repo: {}", repo.get_id()));
+
+    if (forked_repo != forked_repos.end()) {
+        forked_repos.erase(forked_repo);
+    } else {
+        repo_impl->detach_libsolv_repo();
+        repo_impl->libsolv_repo_ext.main_nsolvables = 0;
+        repo_impl->libsolv_repo_ext.main_nrepodata = 0;
+        repo_impl->libsolv_repo_ext.main_end = 0;
+        repo_impl->libsolv_repo_ext.load_flags = LoadRepoFlags::NONE;
+    }
+    if (pool->installed == libsolv_repo) {
+        pool_set_installed(pool, nullptr);
+    }
+    // the freed solvables are left as holes in the pool unless they are at its end
+    repo_free(libsolv_repo, 1);
+
+    // the whatprovides index and the caches contain ids of the freed solvables
+    pool_freewhatprovides(pool);
+    provides_ready = false;
+    considered_uptodate = false;
+    forked_data.p_impl->clear();
+    invalidate_solvables_caches();
+    // package sets and queries hold ids of the freed solvables
+    data_guard.clear();
+
+    if (system_repo.get() == &repo) {
+        system_repo.reset();
+    }
+}
+
+void SolvSack::Impl::drop_repo_extensions(Repo & repo, LoadRepoFlags flags) {
+    if (any(flags & LoadRepoFlags::USE_UPDATEINFO)) {
+        throw LogicError(
+            "SolvSack::drop_repo_extensions(): Updateinfo cannot be dropped, the repository must be unloaded");
+    }
+    auto & libsolv_repo_ext = repo.p_impl->libsolv_repo_ext;
+    auto libsolv_repo = libsolv_repo_ext.repo;
+    if (!libsolv_repo || libsolv_repo->pool != pool) {
+        throw LogicError(
+            fmt::format("SolvSack::drop_repo_extensions(): Repository \"{}\" is not loaded", repo.get_id()));
+    }
+    // repodata_free() renumbers the following repodata, they are freed from the last one
+    for (Id data_id = libsolv_repo->nrepodata - 1; data_id >= libsolv_repo_ext.main_nrepodata; --data_id) {
+        auto data = repo_id2repodata(libsolv_repo, data_id);
+        for (auto & extension : REPODATA_EXTENSIONS) {
+            if (any(flags & extension.load_flag) && extension.stub_keyname &&
+                repodata_has_keyname(data, extension.stub_keyname)) {
+                base->get_logger().debug(
+                    fmt::format("dropping {} of repo: {}", extension.md_filename, repo.get_id()));
+                repodata_free(data);
+                break;
             }
-        } catch (const NoCapability & ex) {
-            logger.debug(fmt::format("no other metadata available for {}", repo_impl->id));
         }
     }
-    if (any(flags & LoadRepoFlags::USE_PRESTO)) {
-        try {
-            auto repodata_info = load_repo_ext(
-                repo,
-                SOLV_EXT_PRESTO,
-                Repo::Impl::MD_FILENAME_PRESTODELTA,
-                REPO_EXTEND_SOLVABLES,
-                [](LibsolvRepo * repo, FILE * fp) { return repo_add_deltainfoxml(repo, fp, 0) == 0; });
-            if (repodata_info.state == RepodataState::LOADED_FETCH && build_cache) {
-                write_ext(repo_impl->libsolv_repo_ext, repodata_info.id, RepodataType::PRESTO, SOLV_EXT_PRESTO);
+    libsolv_repo_ext.load_flags = static_cast<LoadRepoFlags>(
+        static_cast<std::underlying_type_t<LoadRepoFlags>>(libsolv_repo_ext.load_flags) &
+        ~static_cast<std::underlying_type_t<LoadRepoFlags>>(flags));
+}
+
+void SolvSack::Impl::fork_into(Impl & child) {
+    // the copies contain the added file provides, they are not searched again in the child
+    make_provides_ready();
+
+    // the data are not versioned by a checksum, the copies are dropped whenever the sack changes
+    const unsigned char no_checksum[CHKSUM_BYTES]{};
+    Id repo_id;
+    LibsolvRepo * libsolv_repo;
+    FOR_REPOS(repo_id, libsolv_repo) {
+        auto repo = static_cast<Repo *>(libsolv_repo->appdata);
+        if (!repo) {
+            // the repository was copied from the parent of this sack
+            for (auto & [forked_repo, forked_repo_id] : forked_repos) {
+                if (forked_repo_id == repo_id) {
+                    repo = forked_repo;
+                }
             }
-        } catch (const NoCapability & ex) {
-            logger.debug(fmt::format("no presto metadata available for {}", repo_impl->id));
         }
-    }
-    // updateinfo must come *after* all other extensions, as it is not a real
-    //   extension, but contains a new set of packages
-    if (any(flags & LoadRepoFlags::USE_UPDATEINFO)) {
-        try {
-            // the updateinfo is not a real extension flags = 0
-            auto repodata_info = load_repo_ext(
-                repo, SOLV_EXT_UPDATEINFO, Repo::Impl::MD_FILENAME_UPDATEINFO, 0, [](LibsolvRepo * repo, FILE * fp) {
-                    return repo_add_updateinfoxml(repo, fp, 0) == 0;
-                });
-            if (repodata_info.state == RepodataState::LOADED_FETCH && build_cache) {
-                write_ext(repo_impl->libsolv_repo_ext, repodata_info.id, RepodataType::UPDATEINFO, SOLV_EXT_UPDATEINFO);
+
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp(
+            forked_data.p_impl->open(libsolv_repo->name, no_checksum), &close_file);
+        if (!fp) {
+            // copy main data only, the extensions are not available in the child
+            int oldnrepodata = libsolv_repo->nrepodata;
+            int oldnsolvables = libsolv_repo->nsolvables;
+            int oldend = libsolv_repo->end;
+            if (libsolv_repo->appdata) {
+                auto & libsolv_repo_ext = repo->p_impl->libsolv_repo_ext;
+                libsolv_repo->nrepodata = libsolv_repo_ext.main_nrepodata;
+                libsolv_repo->nsolvables = libsolv_repo_ext.main_nsolvables;
+                libsolv_repo->end = libsolv_repo_ext.main_end;
             }
-        } catch (const NoCapability & ex) {
-            logger.debug(fmt::format("no updateinfo available for {}", repo_impl->id));
+            forked_data.p_impl->store(libsolv_repo->name, no_checksum, libsolv_repo);
+            libsolv_repo->nrepodata = oldnrepodata;
+            libsolv_repo->nsolvables = oldnsolvables;
+            libsolv_repo->end = oldend;
+            fp.reset(forked_data.p_impl->open(libsolv_repo->name, no_checksum));
+        }
+        std::unique_ptr<LibsolvRepo, decltype(&libsolv_repo_free)> child_repo(
+            repo_create(child.pool, libsolv_repo->name), &libsolv_repo_free);
+        if (!fp || repo_add_solv(child_repo.get(), fp.get(), 0) != 0) {
+            throw Exception(fmt::format(_("fork() failed to copy repository \"{}\""), libsolv_repo->name));
         }
+        child_repo->priority = libsolv_repo->priority;
+        child_repo->subpriority = libsolv_repo->subpriority;
+        child.invalidate_provides();
+
+        if (libsolv_repo == pool->installed) {
+            child.system_repo = child.new_system_repo(false);
+            auto & libsolv_repo_ext = child.system_repo->p_impl->libsolv_repo_ext;
+            child.system_repo->p_impl->attach_libsolv_repo(child_repo.release());
+            pool_set_installed(child.pool, libsolv_repo_ext.repo);
+            libsolv_repo_ext.main_nsolvables = libsolv_repo_ext.repo->nsolvables;
+            libsolv_repo_ext.main_nrepodata = libsolv_repo_ext.repo->nrepodata;
+            libsolv_repo_ext.main_end = libsolv_repo_ext.repo->end;
+        } else if (repo) {
+            child.forked_repos.emplace(repo, child_repo.release()->repoid);
+        } else {
+            child_repo.release();
+        }
+    }
+    child.considered_uptodate = false;
+    child.get_solvables();
+}
+
+std::unique_ptr<Repo> SolvSack::Impl::new_system_repo(bool build_cache) {
+    auto repo_config = std::make_unique<ConfigRepo>(base->get_config());
+    repo_config->build_cache().set(libdnf::Option::Priority::RUNTIME, build_cache);
+    return std::make_unique<Repo>(SYSTEM_REPO_NAME, std::move(repo_config), *base, Repo::Type::SYSTEM);
+}
+
+bool SolvSack::Impl::snapshot_repo_checksum(Repo & repo, unsigned char * checksum) {
+    auto repo_impl = repo.p_impl.get();
+    if (repo_impl->type == Repo::Type::SYSTEM) {
+        return rpmdb_checksum(base->get_config().installroot().get_value(), checksum);
+    }
+    if (repo_impl->repomd_fn.empty()) {
+        throw Exception("repo md file name is empty");
+    }
+    repomd_checksum(
+        repo_impl->repomd_fn.c_str(),
+        give_repomd_stat_fn(repo.get_id()),
+        repo.get_config()->build_cache().get_value(),
+        checksum);
+    return true;
+}
+
+void SolvSack::Impl::snapshot_key_add_repo(
+    Chksum * h, const Repo & repo, LoadRepoFlags flags, const unsigned char * checksum) {
+    auto & id = repo.get_id();
+    unsigned char is_system = repo.p_impl->type == Repo::Type::SYSTEM ? 1 : 0;
+    if (is_system) {
+        // extensions are not loaded for the system repository
+        flags = LoadRepoFlags::NONE;
+    }
+    auto flags_value = static_cast<uint32_t>(flags);
+    solv_chksum_add(h, id.c_str(), static_cast<int>(id.size() + 1));
+    solv_chksum_add(h, &is_system, sizeof(is_system));
+    solv_chksum_add(h, &flags_value, sizeof(flags_value));
+    solv_chksum_add(h, checksum, CHKSUM_BYTES);
+}
+
+void SolvSack::Impl::write_snapshot(const std::string & path) {
+    auto & logger = base->get_logger();
+
+    // the stored main data contain the file provides, the sorted index is created for the current solvables
+    make_provides_ready();
+    auto & nevra_sorted_solvables = get_nevra_sorted_solvables();
+
+    auto h = solv_chksum_create(CHKSUM_TYPE);
+    solv_chksum_add(h, SNAPSHOT_IDENT, strlen(SNAPSHOT_IDENT));
+    std::vector<LibsolvRepo *> libsolv_repos;
+    Id repo_id;
+    LibsolvRepo * r;
+    FOR_REPOS(repo_id, r) {
+        auto repo = static_cast<Repo *>(r->appdata);
+        if (!repo || repo->p_impl->type == Repo::Type::COMMANDLINE) {
+            solv_chksum_free(h, nullptr);
+            throw LogicError(
+                fmt::format("SolvSack::write_snapshot(): Repository \"{}\" cannot be stored in snapshot", r->name));
+        }
+        // the stored data are keyed on the checksum the repository was loaded with, not on the current metadata
+        auto & libsolv_repo_ext = repo->p_impl->libsolv_repo_ext;
+        snapshot_key_add_repo(h, *repo, libsolv_repo_ext.load_flags, libsolv_repo_ext.checksum);
+        libsolv_repos.push_back(r);
+    }
+    unsigned char key[CHKSUM_BYTES];
+    solv_chksum_free(h, key);
+
+    auto tmp_fn_templ = path + ".XXXXXX";
+    int tmp_fd = mkstemp(tmp_fn_templ.data());
+    if (tmp_fd == -1) {
+        throw SystemError(errno, fmt::format(_("cannot create temporary file: {}"), tmp_fn_templ));
+    }
+    auto fp = fdopen(tmp_fd, "w");
+    if (!fp) {
+        auto tmp_err = errno;
+        close(tmp_fd);
+        unlink(tmp_fn_templ.c_str());
+        throw SystemError(tmp_err, _("failed opening tmp file"));
+    }
+
+    bool ok = fwrite(SNAPSHOT_IDENT, strlen(SNAPSHOT_IDENT), 1, fp) == 1 && fwrite(key, CHKSUM_BYTES, 1, fp) == 1;
+    for (auto libsolv_repo : libsolv_repos) {
+        if (!ok) {
+            break;
+        }
+        // write main data only, the extensions are loaded from their own solvx caches
+        auto & libsolv_repo_ext = static_cast<Repo *>(libsolv_repo->appdata)->p_impl->libsolv_repo_ext;
+        int oldnrepodata = libsolv_repo->nrepodata;
+        int oldnsolvables = libsolv_repo->nsolvables;
+        int oldend = libsolv_repo->end;
+        libsolv_repo->nrepodata = libsolv_repo_ext.main_nrepodata;
+        libsolv_repo->nsolvables = libsolv_repo_ext.main_nsolvables;
+        libsolv_repo->end = libsolv_repo_ext.main_end;
+        ok = repo_write(libsolv_repo, fp) == 0;
+        libsolv_repo->nrepodata = oldnrepodata;
+        libsolv_repo->nsolvables = oldnsolvables;
+        libsolv_repo->end = oldend;
+    }
+
+    // The NEVRA sorted index does not depend on the string ids, it is the same in a pool restored from the snapshot.
+    // The solvables are stored as the index of the repository and the offset in its main data, the ids of solvables
+    // differ in the restored pool when the extensions add solvables (advisories).
+    std::vector<uint32_t> repo_idxs(static_cast<size_t>(pool->nrepos), 0);
+    for (size_t idx = 0; idx < libsolv_repos.size(); ++idx) {
+        repo_idxs[static_cast<size_t>(libsolv_repos[idx]->repoid)] = static_cast<uint32_t>(idx);
+    }
+    std::vector<uint32_t> sorted_index;
+    sorted_index.reserve(nevra_sorted_solvables.size() * 2);
+    for (PackageId id : nevra_sorted_solvables) {
+        Solvable * solvable = pool_id2solvable(pool, id.id);
+        sorted_index.push_back(repo_idxs[static_cast<size_t>(solvable->repo->repoid)]);
+        sorted_index.push_back(static_cast<uint32_t>(id.id - solvable->repo->start));
+    }
+    auto count = static_cast<uint32_t>(nevra_sorted_solvables.size());
+    ok = ok && fwrite(&count, sizeof(count), 1, fp) == 1 &&
+         (count == 0 || fwrite(sorted_index.data(), sizeof(uint32_t) * 2, count, fp) == count);
+    ok = fclose(fp) == 0 && ok;
+    if (!ok) {
+        unlink(tmp_fn_templ.c_str());
+        throw Exception(_("write_snapshot() failed writing data"));
+    }
+
+    try {
+        std::filesystem::rename(tmp_fn_templ, path);
+    } catch (...) {
+        unlink(tmp_fn_templ.c_str());
+        throw;
+    }
+    logger.debug(fmt::format("sack snapshot written: {}", path));
+}
+
+bool SolvSack::Impl::load_snapshot(
+    const std::string & path, const std::vector<Repo *> & repos, LoadRepoFlags flags, bool with_system_repo) {
+    if (pool->urepos != 0 || system_repo) {
+        throw LogicError("SolvSack::load_snapshot(): Snapshot can be loaded only into empty SolvSack");
+    }
+    for (auto repo : repos) {
+        if (repo->p_impl->type != Repo::Type::AVAILABLE) {
+            throw LogicError("SolvSack::load_snapshot(): User can load only \"available\" repository");
+        }
+    }
+    auto & logger = base->get_logger();
+
+    std::unique_ptr<std::FILE, decltype(&close_file)> fp(open_solv_file(path.c_str()), &close_file);
+    if (!fp) {
+        return false;
+    }
+
+    std::vector<Repo *> snapshot_repos;
+    std::unique_ptr<Repo> new_system;
+    if (with_system_repo) {
+        new_system = new_system_repo(false);
+        snapshot_repos.push_back(new_system.get());
+    }
+    snapshot_repos.insert(snapshot_repos.end(), repos.begin(), repos.end());
+
+    auto h = solv_chksum_create(CHKSUM_TYPE);
+    solv_chksum_add(h, SNAPSHOT_IDENT, strlen(SNAPSHOT_IDENT));
+    // the checksums are assigned to the repositories only if the snapshot is used
+    std::vector<std::array<unsigned char, CHKSUM_BYTES>> checksums(snapshot_repos.size());
+    for (size_t idx = 0; idx < snapshot_repos.size(); ++idx) {
+        if (!snapshot_repo_checksum(*snapshot_repos[idx], checksums[idx].data())) {
+            solv_chksum_free(h, nullptr);
+            return false;
+        }
+        snapshot_key_add_repo(h, *snapshot_repos[idx], flags, checksums[idx].data());
+    }
+    unsigned char key[CHKSUM_BYTES];
+    solv_chksum_free(h, key);
+
+    char ident[4];
+    unsigned char stored_key[CHKSUM_BYTES];
+    if (fread(ident, sizeof(ident), 1, fp.get()) != 1 || memcmp(ident, SNAPSHOT_IDENT, sizeof(ident)) != 0 ||
+        fread(stored_key, CHKSUM_BYTES, 1, fp.get()) != 1 || memcmp(stored_key, key, CHKSUM_BYTES) != 0) {
+        logger.debug(fmt::format("sack snapshot {} does not match the repositories", path));
+        return false;
+    }
+
+    // nothing is attached to the sack until the whole snapshot is read
+    std::vector<std::unique_ptr<LibsolvRepo, decltype(&libsolv_repo_free)>> libsolv_repos;
+    for (auto repo : snapshot_repos) {
+        libsolv_repos.emplace_back(repo_create(pool, repo->get_id().c_str()), &libsolv_repo_free);
+        if (repo_add_solv(libsolv_repos.back().get(), fp.get(), 0) != 0) {
+            logger.warning(fmt::format("load_snapshot(): failed loading {}: {}", path, pool_errstr(pool)));
+            return false;
+        }
+    }
+    uint32_t count;
+    std::vector<uint32_t> sorted_index;
+    bool index_ok = fread(&count, sizeof(count), 1, fp.get()) == 1 &&
+                    count <= static_cast<uint32_t>(pool->nsolvables);
+    if (index_ok) {
+        sorted_index.resize(static_cast<size_t>(count) * 2);
+        index_ok = count == 0 || fread(sorted_index.data(), sizeof(uint32_t) * 2, count, fp.get()) == count;
+    }
+    advise_paged_access(fp.get());
+
+    for (size_t idx = 0; idx < snapshot_repos.size(); ++idx) {
+        auto repo_impl = snapshot_repos[idx]->p_impl.get();
+        repo_impl->attach_libsolv_repo(libsolv_repos[idx].release());
+        auto & libsolv_repo_ext = repo_impl->libsolv_repo_ext;
+        memcpy(libsolv_repo_ext.checksum, checksums[idx].data(), CHKSUM_BYTES);
+        libsolv_repo_ext.main_nsolvables = libsolv_repo_ext.repo->nsolvables;
+        libsolv_repo_ext.main_nrepodata = libsolv_repo_ext.repo->nrepodata;
+        libsolv_repo_ext.main_end = libsolv_repo_ext.repo->end;
+        if (repo_impl->type == Repo::Type::SYSTEM) {
+            pool_set_installed(pool, libsolv_repo_ext.repo);
+        } else {
+            load_repo_extensions(*snapshot_repos[idx], flags);
+        }
+        invalidate_provides();
+    }
+    if (new_system) {
+        system_repo = std::move(new_system);
     }
     considered_uptodate = false;
+    auto & solvables = get_solvables();
+
+    // the stored index is used only if it is consistent with the loaded solvables, otherwise it is created again
+    index_ok = index_ok && count == static_cast<uint32_t>(solvables.size());
+    std::vector<PackageId> nevra_sorted_solvables;
+    nevra_sorted_solvables.reserve(count);
+    for (size_t idx = 0; index_ok && idx < sorted_index.size(); idx += 2) {
+        auto repo_idx = sorted_index[idx];
+        auto offset = sorted_index[idx + 1];
+        if (repo_idx >= snapshot_repos.size()) {
+            index_ok = false;
+            break;
+        }
+        auto & libsolv_repo_ext = snapshot_repos[repo_idx]->p_impl->libsolv_repo_ext;
+        auto id = libsolv_repo_ext.repo->start + static_cast<Id>(offset);
+        index_ok = offset < static_cast<uint32_t>(libsolv_repo_ext.main_end - libsolv_repo_ext.repo->start) &&
+                   solvables.contains_unsafe(PackageId(id));
+        nevra_sorted_solvables.push_back(PackageId(id));
+    }
+    if (index_ok) {
+        cached_nevra_sorted_solvables = std::move(nevra_sorted_solvables);
+        cached_nevra_sorted_solvables_size = get_nsolvables();
+    }
+    logger.debug(fmt::format("sack restored from snapshot: {}", path));
+    return true;
+}
+
+void SolvSack::Impl::build_repo_cache(Repo & repo, LoadRepoFlags flags) {
+    if (!repo.get_config()->build_cache().get_value()) {
+        return;
+    }
+    auto repo_impl = repo.p_impl.get();
+    if (repo_impl->repomd_fn.empty()) {
+        throw Exception("repo md file name is empty");
+    }
+
+    auto & logger = base->get_logger();
+    auto & id = repo.get_id();
+    const char * fn_repomd = repo_impl->repomd_fn.c_str();
+
+    // The staging repository lives in a private pool. Libsolv does not share any state between pools.
+    std::unique_ptr<Pool, decltype(&pool_free)> staging_pool(pool_create(), &pool_free);
+    LibsolvRepoExt staging_repo_ext;
+    auto libsolv_repo = repo_create(staging_pool.get(), id.c_str());
+    staging_repo_ext.repo = libsolv_repo;
+    repomd_checksum(fn_repomd, give_repomd_stat_fn(id), true, staging_repo_ext.checksum);
+
+    // only the checksum at the end of the cache file is read, compressed data are not decompressed
+    auto open_valid_cache = [&](const char * suffix) {
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp(
+            open_solv_file(give_repo_solv_cache_fn(id, suffix).c_str()), &close_file);
+        if (!can_use_repomd_cache(fp.get(), staging_repo_ext.checksum)) {
+            fp.reset();
+        }
+        return fp;
+    };
+
+    // the extensions loaded on demand are parsed and cached on their first use, many commands never need them
+    std::vector<const RepodataExtension *> missing_extensions;
+    for (auto & extension : REPODATA_EXTENSIONS) {
+        if (any(flags & extension.load_flag) && !extension.stub_keyname &&
+            !repo.get_metadata_path(extension.md_filename).empty() && !open_valid_cache(extension.solv_suffix)) {
+            missing_extensions.push_back(&extension);
+        }
+    }
+    auto fp_cache = open_valid_cache(nullptr);
+    if (fp_cache && missing_extensions.empty()) {
+        return;
+    }
+
+    if (fp_cache && prepare_solv_data(fp_cache)) {
+        // the extensions extend solvables of the main data
+        if (repo_add_solv(libsolv_repo, fp_cache.get(), 0)) {
+            throw Exception(_("repo_add_solv() has failed."));
+        }
+    } else {
+        auto primary = repo.get_metadata_path(Repo::Impl::MD_FILENAME_PRIMARY);
+        if (primary.empty()) {
+            throw Exception(_("loading of MD_FILENAME_PRIMARY has failed."));
+        }
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp_primary(utils::open_decompressed(primary), &close_file);
+        if (!fp_primary) {
+            throw Exception(fmt::format(_("failed to open: {}"), primary));
+        }
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp_repomd(fopen(fn_repomd, "rb"), &close_file);
+        if (!fp_repomd) {
+            throw SystemError(errno, fn_repomd);
+        }
+        logger.debug(fmt::format("building solv cache of {}", id));
+        if (repo_add_repomdxml(libsolv_repo, fp_repomd.get(), 0) ||
+            repo_add_rpmmd(libsolv_repo, fp_primary.get(), 0, 0)) {
+            throw Exception(_("repo_add_repomdxml/rpmmd() has failed."));
+        }
+        write_main(staging_repo_ext, false);
+    }
+    staging_repo_ext.main_nsolvables = libsolv_repo->nsolvables;
+    staging_repo_ext.main_nrepodata = libsolv_repo->nrepodata;
+    staging_repo_ext.main_end = libsolv_repo->end;
+
+    for (auto extension : missing_extensions) {
+        auto fn = repo.get_metadata_path(extension->md_filename);
+        std::unique_ptr<std::FILE, decltype(&close_file)> fp(utils::open_decompressed(fn), &close_file);
+        if (!fp) {
+            throw Exception(fmt::format(_("failed to open: {}"), fn));
+        }
+        logger.debug(fmt::format("{}: building solv cache from: {}", __func__, fn));
+        if (extension->parse(libsolv_repo, fp.get(), 0)) {
+            write_ext(staging_repo_ext, libsolv_repo->nrepodata - 1, extension->type, extension->solv_suffix, false);
+        }
+    }
 }
 
 
@@ -562,17 +1537,53 @@ void SolvSack::load_repo(Repo & repo, LoadRepoFlags flags) {
     pImpl->load_available_repo(repo, flags);
 }
 
+void SolvSack::build_repo_cache(Repo & repo, LoadRepoFlags flags) {
+    auto repo_impl = repo.p_impl.get();
+    if (repo_impl->type != Repo::Type::AVAILABLE) {
+        throw LogicError("SolvSack::build_repo_cache(): User can build cache only for \"available\" repository");
+    }
+    pImpl->build_repo_cache(repo, flags);
+}
+
 void SolvSack::create_system_repo(bool build_cache) {
     if (pImpl->system_repo) {
         throw LogicError("SolvSack::create_system_repo(): System repo already exists");
     }
-    auto repo_config = std::make_unique<ConfigRepo>(pImpl->base->get_config());
-    repo_config->build_cache().set(libdnf::Option::Priority::RUNTIME, build_cache);
-    pImpl->system_repo =
-        std::make_unique<Repo>(SYSTEM_REPO_NAME, std::move(repo_config), *pImpl->base, Repo::Type::SYSTEM);
+    pImpl->system_repo = pImpl->new_system_repo(build_cache);
     pImpl->load_system_repo();
 }
 
+void SolvSack::write_snapshot(const std::string & path) {
+    pImpl->write_snapshot(path);
+}
+
+bool SolvSack::load_snapshot(
+    const std::string & path, const std::vector<Repo *> & repos, LoadRepoFlags flags, bool with_system_repo) {
+    return pImpl->load_snapshot(path, repos, flags, with_system_repo);
+}
+
+void SolvSack::set_shared_repo_cache(std::shared_ptr<SharedRepoCache> cache) {
+    pImpl->shared_repo_cache = std::move(cache);
+}
+
+std::unique_ptr<SolvSack> SolvSack::fork() {
+    auto child = std::make_unique<SolvSack>(*pImpl->base);
+    pImpl->fork_into(*child->pImpl);
+    return child;
+}
+
+void SolvSack::unload_repo(Repo & repo) {
+    pImpl->unload_repo(repo);
+}
+
+void SolvSack::drop_repo_extensions(Repo & repo, LoadRepoFlags flags) {
+    pImpl->drop_repo_extensions(repo, flags);
+}
+
+SolvSackMemoryUsage SolvSack::get_memory_usage() const {
+    return pImpl->get_memory_usage();
+}
+
 void SolvSack::dump_debugdata(const std::string & dir) {
     Solver *solver = solver_create(pImpl->pool);
 
@@ -593,7 +1604,130 @@ SolvSackWeakPtr SolvSack::get_weak_ptr() {
     return SolvSackWeakPtr(this, &pImpl->data_guard);
 }
 
+SolvSackMemoryUsage SolvSack::Impl::get_memory_usage() {
+    SolvSackMemoryUsage usage;
+    // indexes of the repositories in `usage.repos` by the libsolv repository ids
+    std::vector<std::size_t> repo_usage_indexes(static_cast<std::size_t>(pool->nrepos));
+    Id repo_id;
+    LibsolvRepo * libsolv_repo;
+    FOR_REPOS(repo_id, libsolv_repo) {
+        repo_usage_indexes[static_cast<std::size_t>(repo_id)] = usage.repos.size();
+        RepoMemoryUsage repo_usage;
+        repo_usage.repo_id = libsolv_repo->name;
+        repo_usage.solvables = static_cast<std::size_t>(libsolv_repo->nsolvables) * sizeof(Solvable);
+        if (libsolv_repo->rpmdbid) {
+            repo_usage.solvables += static_cast<std::size_t>(libsolv_repo->end - libsolv_repo->start) * sizeof(Id);
+        }
+        repo_usage.dependencies = static_cast<std::size_t>(libsolv_repo->idarraysize) * sizeof(Id);
+
+        auto repo = static_cast<Repo *>(libsolv_repo->appdata);
+        int main_nrepodata = repo ? repo->p_impl->libsolv_repo_ext.main_nrepodata : libsolv_repo->nrepodata;
+        for (Id data_id = 1; data_id < libsolv_repo->nrepodata; ++data_id) {
+            auto data = repo_id2repodata(libsolv_repo, data_id);
+            if (data->localpool) {
+                repo_usage.strings += stringpool_memory(data->spool);
+            }
+            // the repodata with the stubs of extensions belongs to the main data
+            std::size_t * data_usage = &repo_usage.main_repodata;
+            if (data_id >= main_nrepodata && !repodata_has_keyname(data, REPOSITORY_EXTERNAL)) {
+                // updateinfo is the only extension which is not recognized by a key
+                data_usage = &repo_usage.updateinfo;
+                for (auto & extension : REPODATA_EXTENSIONS) {
+                    if (!extension.stub_keyname || !repodata_has_keyname(data, extension.stub_keyname)) {
+                        continue;
+                    }
+                    switch (extension.type) {
+                        case RepodataType::FILENAMES:
+                            data_usage = &repo_usage.filelists;
+                            break;
+                        case RepodataType::OTHER:
+                            data_usage = &repo_usage.other;
+                            break;
+                        case RepodataType::PRESTO:
+                            data_usage = &repo_usage.presto;
+                            break;
+                        case RepodataType::UPDATEINFO:
+                            break;
+                    }
+                }
+            }
+            *data_usage += repodata_memory(data);
+        }
+        usage.repos.push_back(std::move(repo_usage));
+    }
+
+    // The entries of the indexes are attributed to the repositories of their solvables. The tables indexed
+    // by the string and relation ids, the list terminators, the unused capacity and the string pools are shared.
+    auto solvable_repo_usage = [&](Id solvable_id) -> RepoMemoryUsage * {
+        if (solvable_id < 2 || solvable_id >= pool->nsolvables) {
+            return nullptr;
+        }
+        auto solvable_repo = pool_id2solvable(pool, solvable_id)->repo;
+        if (!solvable_repo) {
+            return nullptr;
+        }
+        return &usage.repos[repo_usage_indexes[static_cast<std::size_t>(solvable_repo->repoid)]];
+    };
+
+    usage.string_pool = stringpool_memory(pool->ss);
+    usage.relations = static_cast<std::size_t>(pool->nrels) * sizeof(Reldep);
+    if (pool->whatprovides) {
+        usage.whatprovides = static_cast<std::size_t>(pool->ss.nstrings) * sizeof(Offset);
+        if (pool->whatprovides_rel) {
+            usage.whatprovides += static_cast<std::size_t>(pool->nrels) * sizeof(Offset);
+        }
+        auto whatprovides_data_size = static_cast<std::size_t>(pool->whatprovidesdataoff) +
+                                      static_cast<std::size_t>(pool->whatprovidesdataleft);
+        usage.whatprovides += whatprovides_data_size * sizeof(Id);
+        for (Offset offset = 0; offset < pool->whatprovidesdataoff; ++offset) {
+            if (auto repo_usage = solvable_repo_usage(pool->whatprovidesdata[offset])) {
+                repo_usage->whatprovides += sizeof(Id);
+                usage.whatprovides -= sizeof(Id);
+            }
+        }
+    }
+
+    usage.libdnf_indexes = static_cast<std::size_t>(cached_solvables.map.size);
+    usage.libdnf_indexes +=
+        (cached_sorted_solvables.capacity() + cached_nevra_sorted_solvables.capacity()) * sizeof(PackageId);
+    usage.libdnf_indexes += cached_solvables_evr.capacity() * sizeof(SolvableEvr);
+    usage.libdnf_indexes += stringpool_memory(evr_strings);
+    // the set of solvables has one bit per solvable id, the whole bytes within a repository are attributed to it
+    FOR_REPOS(repo_id, libsolv_repo) {
+        auto end = std::min(libsolv_repo->end, cached_solvables.map.size << 3);
+        if (end > libsolv_repo->start) {
+            auto size = static_cast<std::size_t>((end - libsolv_repo->start) >> 3);
+            usage.repos[repo_usage_indexes[static_cast<std::size_t>(repo_id)]].libdnf_indexes += size;
+            usage.libdnf_indexes -= size;
+        }
+    }
+    for (auto * sorted_solvables : {&cached_sorted_solvables, &cached_nevra_sorted_solvables}) {
+        for (auto package_id : *sorted_solvables) {
+            if (auto repo_usage = solvable_repo_usage(package_id.id)) {
+                repo_usage->libdnf_indexes += sizeof(PackageId);
+                usage.libdnf_indexes -= sizeof(PackageId);
+            }
+        }
+    }
+    for (Id solvable_id = 0; solvable_id < static_cast<Id>(cached_solvables_evr.size()); ++solvable_id) {
+        if (auto repo_usage = solvable_repo_usage(solvable_id)) {
+            repo_usage->libdnf_indexes += sizeof(SolvableEvr);
+            usage.libdnf_indexes -= sizeof(SolvableEvr);
+        }
+    }
+    return usage;
+}
+
+bool SolvSack::Impl::compress_solv_cache() {
+    return base->get_config().solv_cache_compression().get_value() == "zstd";
+}
+
 // TODO(jrohel): we want to change directory for solv(x) cache (into repo metadata directory?)
+std::string SolvSack::Impl::give_repomd_stat_fn(const std::string & repoid) {
+    std::filesystem::path cachedir = base->get_config().cachedir().get_value();
+    return cachedir / (repoid + REPOMD_STAT_SUFFIX);
+}
+
 std::string SolvSack::Impl::give_repo_solv_cache_fn(const std::string & repoid, const char * ext) {
     std::filesystem::path cachedir = base->get_config().cachedir().get_value();
     auto fn = cachedir / repoid;
@@ -606,6 +1740,84 @@ std::string SolvSack::Impl::give_repo_solv_cache_fn(const std::string & repoid,
     return fn;
 }
 
+SharedRepoCache::Impl::~Impl() {
+    clear();
+}
+
+std::FILE * SharedRepoCache::Impl::open(const std::string & repo_id, const unsigned char checksum[CHKSUM_BYTES]) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = entries.find(repo_id);
+    if (it == entries.end() || memcmp(it->second.checksum, checksum, CHKSUM_BYTES) != 0) {
+        return nullptr;
+    }
+    // a new open file description, the file offset is not shared with the other SolvSacks reading the data
+    int fd = ::open(fmt::format("/proc/self/fd/{}", it->second.fd).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+    auto fp = fdopen(fd, "rb");
+    if (!fp) {
+        close(fd);
+    }
+    return fp;
+}
+
+void SharedRepoCache::Impl::store(
+    const std::string & repo_id, const unsigned char checksum[CHKSUM_BYTES], LibsolvRepo * libsolv_repo) {
+    int fd = create_memory_file("libdnf-shared-repo");
+    if (fd == -1) {
+        return;
+    }
+    int write_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    auto fp = write_fd == -1 ? nullptr : fdopen(write_fd, "wb");
+    if (!fp) {
+        if (write_fd != -1) {
+            close(write_fd);
+        }
+        close(fd);
+        return;
+    }
+    int ret = repo_write(libsolv_repo, fp);
+    ret |= fclose(fp);
+    if (ret) {
+        close(fd);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto [it, inserted] = entries.try_emplace(repo_id, Entry{{}, -1});
+    if (!inserted) {
+        close(it->second.fd);
+    }
+    memcpy(it->second.checksum, checksum, CHKSUM_BYTES);
+    it->second.fd = fd;
+}
+
+void SharedRepoCache::Impl::clear() {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto & [repo_id, entry] : entries) {
+        close(entry.fd);
+    }
+    entries.clear();
+}
+
+std::size_t SharedRepoCache::Impl::size() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return entries.size();
+}
+
+SharedRepoCache::SharedRepoCache() : p_impl{new Impl} {}
+
+SharedRepoCache::~SharedRepoCache() = default;
+
+void SharedRepoCache::clear() {
+    p_impl->clear();
+}
+
+std::size_t SharedRepoCache::size() const {
+    return p_impl->size();
+}
+
 SolvSack::SolvSack(Base & base) : pImpl{new Impl(base)} {}
 
 SolvSack::~SolvSack() = default;
@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF_RPM_SACK_IMPL_HPP
 #define LIBDNF_RPM_SACK_IMPL_HPP
 
+#include "../utils/thread_pool.hpp"
 #include "repo_impl.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/solv_map.hpp"
@@ -29,9 +30,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/rpm/solv_sack.hpp"
 
 extern "C" {
+#include <solv/evr.h>
 #include <solv/pool.h>
+#include <solv/strpool.h>
 }
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <vector>
 
 constexpr const char * SOLVABLE_NAME_ADVISORY_PREFIX = "patch:";
@@ -63,80 +71,258 @@ namespace libdnf::rpm {
 class PackageSet;
 
 
+/// Epoch, version and release of a solvable parsed out of its evr string.
+/// The version and release are Ids into the private evr string pool of the sack (they do not pollute
+/// the string space of the libsolv Pool). Two solvables with equal version strings have equal version Ids.
+struct SolvableEvr {
+    unsigned long epoch{0};
+    Id version{0};
+    Id release{0};
+};
+
+
+class SharedRepoCache::Impl {
+public:
+    ~Impl();
+
+    /// Opens the stored main data of the repository for loading by repo_add_solv(). Returns nullptr if the data
+    /// are not stored or they were stored for other metadata (`checksum` of repomd).
+    std::FILE * open(const std::string & repo_id, const unsigned char checksum[CHKSUM_BYTES]);
+
+    /// Stores the main data of the loaded libsolv repository, older data of the repository are replaced.
+    /// The data are not stored if the memory file cannot be created or written.
+    void store(const std::string & repo_id, const unsigned char checksum[CHKSUM_BYTES], LibsolvRepo * libsolv_repo);
+
+    void clear();
+
+    std::size_t size();
+
+private:
+    struct Entry {
+        unsigned char checksum[CHKSUM_BYTES];
+        int fd;  // anonymous memory file with the solv data
+    };
+
+    std::mutex mutex;
+    std::map<std::string, Entry> entries;
+};
+
+
 class SolvSack::Impl {
 public:
     enum class RepodataType { FILENAMES, PRESTO, UPDATEINFO, OTHER };
-    enum class RepodataState { NEW, LOADED_FETCH, LOADED_CACHE };
+    enum class RepodataState { NEW, LOADED_FETCH, LOADED_CACHE, LOADED_SHARED };
     struct RepodataInfo {
-        RepodataState state;
-        Id id;
+        RepodataState state{RepodataState::NEW};
+        Id id{0};
+    };
+
+    /// Extension metadata type (filelists, other, ...) of an available repository
+    struct RepodataExtension {
+        LoadRepoFlags load_flag;
+        RepodataType type;
+        const char * solv_suffix;  // suffix of the .solvx cache file name
+        const char * md_filename;  // metadata type in repomd
+        int solv_flags;            // flags for adding the data from the .solvx cache file
+        Id stub_keyname;           // key provided by the extension, 0 if the extension is not loaded on demand
+        Id stub_keytype;           // libsolv type of the `stub_keyname` key
+        bool (*parse)(LibsolvRepo * repo, FILE * fp, int flags);
     };
 
+    /// Extension metadata types in the order of loading.
+    /// Updateinfo must come *after* all other extensions, as it is not a real extension,
+    /// but contains a new set of packages. For the same reason it is the only one loaded immediately,
+    /// the other extensions are registered as libsolv repodata stubs and loaded on the first lookup of their key.
+    static const RepodataExtension REPODATA_EXTENSIONS[4];
+
     explicit Impl(Base & base);
     ~Impl();
 
+    /// Return Base the sack belongs to
+    Base & get_base() { return *base; }
+
     /// Return libsolv Pool
     Pool * get_pool() { return pool; };
 
     /// Return number of solvables in pool
     int get_nsolvables() { return pool->nsolvables; };
 
-    /// Return SolvMap with all package solvables
+    /// Return SolvMap with all package solvables.
+    /// The map is updated incrementally, only solvables added to the pool since the previous call are examined.
     solv::SolvMap & get_solvables();
 
-    /// Return sorted list of all package solvables
-    std::vector<Solvable *> & get_sorted_solvables();
+    /// Return sorted list of all package solvables.
+    /// Solvables added to the pool since the previous call are sorted and merged into the list.
+    /// The list stores Ids, libsolv reallocates the array of solvables when new solvables are added.
+    std::vector<PackageId> & get_sorted_solvables();
+
+    /// Return list of all package solvables sorted by name, evr (rpm version comparison) and arch strings.
+    /// Unlike `get_sorted_solvables()`, which orders by string Ids, the order is the human readable NEVRA order.
+    /// Solvables with the same NEVRA are ordered by Id.
+    std::vector<PackageId> & get_nevra_sorted_solvables();
+
+    /// Return table of parsed evr of all solvables indexed by solvable Id.
+    /// The table is built lazily on the first use, it saves splitting of evr strings in the epoch, version
+    /// and release filters.
+    const std::vector<SolvableEvr> & get_solvables_evr();
+
+    /// Return string pool of the version and release Ids from the `SolvableEvr` table
+    Stringpool * get_evr_strings() { return &evr_strings; }
+
+    /// Drop all cached solvable lists, maps and tables, they are rebuilt on the next use.
+    /// Must be called whenever solvables are removed from the pool (e.g. a repository is freed).
+    /// Solvables appended to the pool are picked up by the caches automatically.
+    void invalidate_solvables_caches();
 
 
     void internalize_libsolv_repos();
 
     static void internalize_libsolv_repo(LibsolvRepo * libsolv_repo);
 
+    /// Prepares data of all repositories for concurrent reading of the `keyname` key from several threads.
+    /// Libsolv internalizes repodata, loads repodata stubs and paged data on demand without any locking,
+    /// all are done here. Only the stubs providing the key are loaded. Paging is disabled only for the repodata
+    /// that contain the key, their paged data (e.g. descriptions of the main data, file lists) stay in memory
+    /// until the repository is unloaded (or the extension dropped), libsolv cannot enable paging again.
+    void prepare_parallel_read(Id keyname);
+
+    /// Threads evaluating the query filters in parallel, see `SolvQuery::set_num_workers()`
+    utils::ThreadPool & get_query_workers() { return query_workers; }
+
     void make_provides_ready();
 
 private:
-    /// Loads system repository into SolvSack
-    /// TODO(jrohel): Performance: Implement libsolv cache ("build_cache" argument) of system repo in future.
+    /// Loads system repository into SolvSack.
+    /// If "build_cache" is enabled for the system repository, the rpmdb is read from the solv cache while the rpmdb
+    /// file does not change. An outdated cache is used as a reference when the rpmdb is read.
+    /// @replaces libdnf/dnf-sack.cpp:method:load_system_repo()
     bool load_system_repo();
 
     /// Loads available repository into SolvSack
     void load_available_repo(Repo & repo, LoadRepoFlags flags);
 
+    /// Copies the repositories into the empty `child` sack, see SolvSack::fork()
+    void fork_into(Impl & child);
+
+    /// Removes the repository from SolvSack, see SolvSack::unload_repo()
+    void unload_repo(Repo & repo);
+
+    /// Frees extensions of the repository, see SolvSack::drop_repo_extensions()
+    void drop_repo_extensions(Repo & repo, LoadRepoFlags flags);
+
+    /// Loads the extensions selected by `flags` of the available repository with already loaded main data.
+    void load_repo_extensions(Repo & repo, LoadRepoFlags flags);
+
+    /// Creates the system repository object, its data are not loaded.
+    std::unique_ptr<Repo> new_system_repo(bool build_cache);
+
+    /// Computes checksum of the current metadata of the repository (rpmdb for the system repository)
+    /// into `checksum`. Returns false if the checksum cannot be computed (missing rpmdb).
+    bool snapshot_repo_checksum(Repo & repo, unsigned char * checksum);
+
+    /// Adds the repository id, type, `flags` and metadata `checksum` to the snapshot key `h`.
+    void snapshot_key_add_repo(Chksum * h, const Repo & repo, LoadRepoFlags flags, const unsigned char * checksum);
+
+    /// Computes memory usage of the sack, see SolvSack::get_memory_usage()
+    SolvSackMemoryUsage get_memory_usage();
+
+    /// Writes snapshot of the sack, see SolvSack::write_snapshot()
+    void write_snapshot(const std::string & path);
+
+    /// Loads the repositories from snapshot, see SolvSack::load_snapshot()
+    bool load_snapshot(
+        const std::string & path, const std::vector<Repo *> & repos, LoadRepoFlags flags, bool with_system_repo);
+
+    /// Writes missing or outdated solv cache files of the available repository.
+    /// The metadata are parsed into a private staging pool, no data of the sack are modified. It is safe to call it
+    /// for several repositories from several threads at once and concurrently with loading of other repositories.
+    void build_repo_cache(Repo & repo, LoadRepoFlags flags);
+
     /// Loads main metadata (solvables) from available repo.
     /// @replaces libdnf/dnf-sack.cpp:method:load_yum_repo()
     RepodataState load_repo_main(Repo & repo);
 
     /// Loads additional metadata (filelist, others, ...) from available repo.
+    /// If `stub` is set, the data are loaded into this repodata stub instead of into a new repodata.
     /// @replaces libdnf/dnf-sack.cpp:method:load_ext()
-    RepodataInfo load_repo_ext(
-        Repo & repo, const char * suffix, const char * which_filename, int flags, bool (*cb)(LibsolvRepo *, FILE *));
+    RepodataInfo load_repo_ext(Repo & repo, const RepodataExtension & extension, Repodata * stub = nullptr);
+
+    /// Registers the extensions of the libsolv repository as repodata stubs. Libsolv calls `repodata_stub_loader()`
+    /// to load an extension when its key is looked up for the first time.
+    static void add_repodata_stubs(
+        LibsolvRepo * libsolv_repo, const std::vector<const RepodataExtension *> & extensions);
+
+    /// Load callback of the pool, loads the extension registered as the repodata stub.
+    /// Returns 1 on success, 0 on failure (libsolv marks the repodata as failed).
+    static int repodata_stub_loader(Pool * pool, Repodata * stub, void * sack_impl);
+
+    /// Loads the extension registered as the repodata stub and writes its solv cache if needed.
+    /// It is called from inside of libsolv lookups, no exception is thrown.
+    bool load_repodata_stub(Repodata * stub);
 
     /// Writes solv file with main libsolv repodata.
+    /// The repository can belong to another pool than the sack one, only `switchtosolv` modifies the repository.
     /// @replaces libdnf/dnf-sack.cpp:method:write_main()
     void write_main(LibsolvRepoExt & repo, bool switchtosolv);
 
     /// Writes solvx file with extended libsolv repodata.
+    /// The repository can belong to another pool than the sack one, only `switchtosolv` modifies the repository.
     /// @replaces libdnf/dnf-sack.cpp:method:write_ext()
-    void write_ext(LibsolvRepoExt & libsolv_repo_ext, Id repodata_id, RepodataType which_repodata, const char * suffix);
+    void write_ext(
+        LibsolvRepoExt & libsolv_repo_ext,
+        Id repodata_id,
+        RepodataType which_repodata,
+        const char * suffix,
+        bool switchtosolv);
 
     void rewrite_repos(solv::IdQueue & addedfileprovides, solv::IdQueue & addedfileprovides_inst);
 
+    /// Marks provides of the pool outdated because data were added to the pool.
+    void invalidate_provides() {
+        provides_ready = false;
+        forked_data.p_impl->clear();
+    }
+
+    /// Appends package solvables with Id >= `first_new_id` to `sorted_solvables` and merges them
+    /// into the already sorted part of the list.
+    template <typename Compare>
+    void merge_new_solvables(std::vector<PackageId> & sorted_solvables, int first_new_id, Compare cmp);
+
     /// Constructs libsolv repository cache filename for given repository id and optional extension.
     std::string give_repo_solv_cache_fn(const std::string & repoid, const char * ext = nullptr);
 
+    /// Constructs filename of the file with the stored stat data and checksum of repomd of given repository.
+    /// The checksum of repomd identifies the valid solv cache files, the stat data make it possible to skip
+    /// reading of the unchanged repomd.
+    std::string give_repomd_stat_fn(const std::string & repoid);
+
+    /// Returns true if the solv cache files are written zstd compressed (the "solv_cache_compression" option)
+    bool compress_solv_cache();
+
     bool considered_uptodate{true};
     bool provides_ready{false};
 
     Base * base;
     Pool * pool;
     std::unique_ptr<Repo> system_repo;
+    std::shared_ptr<SharedRepoCache> shared_repo_cache;
+    /// Copies of the repositories made by `fork_into()`, reused by the following forks.
+    /// They are dropped whenever data of the sack change.
+    SharedRepoCache forked_data;
+    /// Repositories copied from the parent sack (libsolv ids), they are not attached to the Repo objects
+    std::map<Repo *, Id> forked_repos;
 
     WeakPtrGuard<SolvSack, false> data_guard;
 
-    std::vector<Solvable *> cached_sorted_solvables;
+    std::vector<PackageId> cached_sorted_solvables;
     int cached_sorted_solvables_size{0};
+    std::vector<PackageId> cached_nevra_sorted_solvables;
+    int cached_nevra_sorted_solvables_size{0};
     solv::SolvMap cached_solvables{0};
     int cached_solvables_size{0};
+    std::vector<SolvableEvr> cached_solvables_evr;
+    Stringpool evr_strings;
+    utils::ThreadPool query_workers;
 
     friend SolvSack;
     friend Package;
@@ -150,6 +336,8 @@ private:
 inline SolvSack::Impl::Impl(Base & base) : base(&base) {
     pool = pool_create();
     pool_set_rootdir(pool, base.get_config().installroot().get_value().c_str());
+    pool_setloadcallback(pool, repodata_stub_loader, this);
+    stringpool_init_empty(&evr_strings);
 }
 
 
@@ -162,46 +350,145 @@ inline SolvSack::Impl::~Impl() {
         }
     }
     pool_free(pool);
+    stringpool_free(&evr_strings);
 }
 
-inline std::vector<Solvable *> & SolvSack::Impl::get_sorted_solvables() {
+inline std::vector<PackageId> & SolvSack::Impl::get_sorted_solvables() {
     auto nsolvables = get_nsolvables();
     if (nsolvables == cached_sorted_solvables_size) {
         return cached_sorted_solvables;
     }
-    auto & solvables_map = get_solvables();
-    cached_sorted_solvables.clear();
-    cached_sorted_solvables.reserve(static_cast<size_t>(nsolvables));
-    for (PackageId id : solvables_map) {
-        cached_sorted_solvables.push_back(pool_id2solvable(pool, id.id));
-    }
-    std::sort(cached_sorted_solvables.begin(), cached_sorted_solvables.end(), nevra_solvable_cmp_key);
+    // get_solvables() invalidates all caches when solvables were removed from the pool
+    get_solvables();
+    auto cmp = [this](PackageId first, PackageId second) {
+        return nevra_solvable_cmp_key(pool_id2solvable(pool, first.id), pool_id2solvable(pool, second.id));
+    };
+    merge_new_solvables(cached_sorted_solvables, cached_sorted_solvables_size, cmp);
     cached_sorted_solvables_size = nsolvables;
     return cached_sorted_solvables;
 }
 
+inline std::vector<PackageId> & SolvSack::Impl::get_nevra_sorted_solvables() {
+    auto nsolvables = get_nsolvables();
+    if (nsolvables == cached_nevra_sorted_solvables_size) {
+        return cached_nevra_sorted_solvables;
+    }
+    get_solvables();
+    auto cmp = [this](PackageId first_id, PackageId second_id) {
+        const Solvable * first = pool_id2solvable(pool, first_id.id);
+        const Solvable * second = pool_id2solvable(pool, second_id.id);
+        if (first->name != second->name) {
+            return strcmp(pool_id2str(pool, first->name), pool_id2str(pool, second->name)) < 0;
+        }
+        if (first->evr != second->evr) {
+            auto ret = pool_evrcmp(pool, first->evr, second->evr, EVRCMP_COMPARE);
+            if (ret != 0) {
+                return ret < 0;
+            }
+        }
+        if (first->arch != second->arch) {
+            return strcmp(pool_id2str(pool, first->arch), pool_id2str(pool, second->arch)) < 0;
+        }
+        return first_id.id < second_id.id;
+    };
+    merge_new_solvables(cached_nevra_sorted_solvables, cached_nevra_sorted_solvables_size, cmp);
+    cached_nevra_sorted_solvables_size = nsolvables;
+    return cached_nevra_sorted_solvables;
+}
+
+template <typename Compare>
+inline void SolvSack::Impl::merge_new_solvables(
+    std::vector<PackageId> & sorted_solvables, int first_new_id, Compare cmp) {
+    auto nsolvables = get_nsolvables();
+    auto old_size = static_cast<std::ptrdiff_t>(sorted_solvables.size());
+    for (Id solvable_id = std::max(first_new_id, 2); solvable_id < nsolvables; ++solvable_id) {
+        if (cached_solvables.contains_unsafe(PackageId(solvable_id))) {
+            sorted_solvables.push_back(PackageId(solvable_id));
+        }
+    }
+    auto new_begin = sorted_solvables.begin() + old_size;
+    std::sort(new_begin, sorted_solvables.end(), cmp);
+    std::inplace_merge(sorted_solvables.begin(), new_begin, sorted_solvables.end(), cmp);
+}
+
 inline solv::SolvMap & SolvSack::Impl::get_solvables() {
     auto nsolvables = get_nsolvables();
     if (nsolvables == cached_solvables_size) {
         return cached_solvables;
     }
+    if (nsolvables < cached_solvables_size) {
+        invalidate_solvables_caches();
+    }
     // map.size is in bytes, << 3 multiplies the number with 8 and gives size in bits
     if (static_cast<int>(nsolvables) > (cached_solvables.map.size << 3)) {
-        cached_solvables = std::move(solv::SolvMap(static_cast<int>(nsolvables)));
-    } else {
-        cached_solvables.clear();
+        map_grow(&cached_solvables.map, nsolvables);
     }
-    Id solvable_id;
 
-    // loop over all package solvables
-    FOR_POOL_SOLVABLES(solvable_id) {
-        if (is_package(pool, solvable_id)) {
+    // loop over package solvables added since the previous call
+    for (Id solvable_id = std::max(cached_solvables_size, 2); solvable_id < nsolvables; ++solvable_id) {
+        if (pool_id2solvable(pool, solvable_id)->repo && is_package(pool, solvable_id)) {
             cached_solvables.add_unsafe(PackageId(solvable_id));
         }
     }
+    cached_solvables_size = nsolvables;
     return cached_solvables;
 }
 
+inline void SolvSack::Impl::invalidate_solvables_caches() {
+    cached_sorted_solvables.clear();
+    cached_sorted_solvables_size = 0;
+    cached_nevra_sorted_solvables.clear();
+    cached_nevra_sorted_solvables_size = 0;
+    cached_solvables.clear();
+    cached_solvables_size = 0;
+    cached_solvables_evr.clear();
+}
+
+inline const std::vector<SolvableEvr> & SolvSack::Impl::get_solvables_evr() {
+    auto nsolvables = static_cast<size_t>(get_nsolvables());
+    if (nsolvables == cached_solvables_evr.size()) {
+        return cached_solvables_evr;
+    }
+    if (nsolvables < cached_solvables_evr.size()) {
+        invalidate_solvables_caches();
+    }
+    // parse only evr of solvables added since the previous call
+    auto first_new_id = std::max(static_cast<Id>(cached_solvables_evr.size()), 2);
+    cached_solvables_evr.resize(nsolvables);
+    for (Id solvable_id = first_new_id; solvable_id < pool->nsolvables; ++solvable_id) {
+        Solvable * solvable = pool_id2solvable(pool, solvable_id);
+        if (!solvable->repo) {
+            continue;
+        }
+        // Same splitting as solv::pool_split_evr(), but without a copy of the evr string
+        const char * evr = pool_id2str(pool, solvable->evr);
+        const char * epoch_end = nullptr;
+        const char * version = evr;
+        const char * e;
+        for (e = evr + 1; *e != ':' && *e != '-' && *e != '\0'; ++e) {
+            ;
+        }
+        if (*e == ':') {
+            epoch_end = e;
+            version = e + 1;
+        }
+        auto & solvable_evr = cached_solvables_evr[static_cast<size_t>(solvable_id)];
+        if (epoch_end) {
+            solvable_evr.epoch = std::strtoul(evr, nullptr, 10);
+        }
+        const char * version_end = strchr(version, '-');
+        if (version_end) {
+            solvable_evr.version =
+                stringpool_strn2id(&evr_strings, version, static_cast<unsigned int>(version_end - version), 1);
+            solvable_evr.release = stringpool_str2id(&evr_strings, version_end + 1, 1);
+        } else {
+            solvable_evr.version = stringpool_str2id(&evr_strings, version, 1);
+            solvable_evr.release = STRID_EMPTY;
+        }
+    }
+    return cached_solvables_evr;
+}
+
 }  // namespace libdnf::rpm
 
 
@@ -0,0 +1,213 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "decompress.hpp"
+
+extern "C" {
+#include <solv/solv_xfopen.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf::utils {
+
+
+namespace {
+
+// Suffixes of the compressed files, see solv_xfopen()
+constexpr const char * COMPRESSED_SUFFIXES[] = {".gz", ".xz", ".lzma", ".bz2", ".zst", ".zck"};
+
+// Size of the chunk decompressed at once by the decompressing thread
+constexpr std::size_t DECOMPRESS_CHUNK_SIZE = 64 * 1024;
+
+
+bool is_compressed(const std::string & path) {
+    return std::any_of(std::begin(COMPRESSED_SUFFIXES), std::end(COMPRESSED_SUFFIXES), [&path](const char * suffix) {
+        auto len = std::strlen(suffix);
+        return path.size() > len && path.compare(path.size() - len, len, suffix) == 0;
+    });
+}
+
+
+// Decompressed data passed from the decompressing thread (producer) to the reader of the stream (consumer)
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t size) : data(size) {}
+
+    /// Appends `len` bytes. Blocks while the buffer is full. Returns false if the reader closed the stream.
+    bool write(const char * buf, std::size_t len);
+
+    /// Reads up to `len` bytes. Blocks while the buffer is empty and the writer did not finish.
+    /// Returns 0 at the end of data and -1 if the decompression failed.
+    ssize_t read(char * buf, std::size_t len);
+
+    /// The writer has no more data, `with_error` is set if the decompression failed.
+    void finish(bool with_error);
+
+    /// The reader closed the stream, the writer is stopped.
+    void close();
+
+private:
+    std::vector<char> data;
+    std::size_t head{0};  // position of the first unread byte
+    std::size_t used{0};
+    bool finished{false};
+    bool failed{false};
+    bool closed{false};
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+};
+
+
+bool RingBuffer::write(const char * buf, std::size_t len) {
+    while (len > 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return closed || used < data.size(); });
+        if (closed) {
+            return false;
+        }
+        auto tail = (head + used) % data.size();
+        auto count = std::min({len, data.size() - used, data.size() - tail});
+        std::memcpy(data.data() + tail, buf, count);
+        used += count;
+        buf += count;
+        len -= count;
+        lock.unlock();
+        not_empty.notify_one();
+    }
+    return true;
+}
+
+
+ssize_t RingBuffer::read(char * buf, std::size_t len) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [this] { return finished || used > 0; });
+    if (used == 0) {
+        return failed ? -1 : 0;
+    }
+    auto count = std::min({len, used, data.size() - head});
+    std::memcpy(buf, data.data() + head, count);
+    head = (head + count) % data.size();
+    used -= count;
+    lock.unlock();
+    not_full.notify_one();
+    return static_cast<ssize_t>(count);
+}
+
+
+void RingBuffer::finish(bool with_error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        failed = with_error;
+    }
+    not_empty.notify_one();
+}
+
+
+void RingBuffer::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    not_full.notify_one();
+}
+
+
+// State of the stream returned by open_decompressed(), the cookie of fopencookie()
+struct DecompressStream {
+    explicit DecompressStream(std::size_t buffer_size) : buffer(buffer_size) {}
+
+    RingBuffer buffer;
+    std::thread decompressor;
+};
+
+
+void decompress(std::FILE * compressed, RingBuffer & buffer) {
+    std::vector<char> chunk(DECOMPRESS_CHUNK_SIZE);
+    std::size_t len;
+    while ((len = std::fread(chunk.data(), 1, chunk.size(), compressed)) > 0) {
+        if (!buffer.write(chunk.data(), len)) {
+            break;
+        }
+    }
+    bool failed = std::ferror(compressed) != 0;
+    std::fclose(compressed);
+    buffer.finish(failed);
+}
+
+
+ssize_t stream_read(void * cookie, char * buf, std::size_t len) {
+    auto ret = static_cast<DecompressStream *>(cookie)->buffer.read(buf, len);
+    if (ret < 0) {
+        errno = EIO;
+    }
+    return ret;
+}
+
+
+int stream_close(void * cookie) {
+    auto stream = static_cast<DecompressStream *>(cookie);
+    stream->buffer.close();
+    if (stream->decompressor.joinable()) {
+        stream->decompressor.join();
+    }
+    delete stream;
+    return 0;
+}
+
+}  // namespace
+
+
+std::FILE * open_decompressed(const std::string & path, std::size_t buffer_size) {
+    auto compressed = solv_xfopen(path.c_str(), "r");
+    if (!compressed || !is_compressed(path) || buffer_size == 0) {
+        return compressed;
+    }
+
+    auto stream = new DecompressStream(buffer_size);
+    cookie_io_functions_t functions{stream_read, nullptr, nullptr, stream_close};
+    auto fp = fopencookie(stream, "r", functions);
+    if (!fp) {
+        delete stream;
+        return compressed;
+    }
+    try {
+        stream->decompressor = std::thread(decompress, compressed, std::ref(stream->buffer));
+    } catch (const std::system_error &) {
+        // the thread cannot be started, the data are decompressed by the reader
+        stream->buffer.finish(false);
+        std::fclose(fp);
+        return compressed;
+    }
+    return fp;
+}
+
+
+}  // namespace libdnf::utils
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_UTILS_DECOMPRESS_HPP
+#define LIBDNF_UTILS_DECOMPRESS_HPP
+
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+
+namespace libdnf::utils {
+
+
+/// Default size of the buffer between the decompressing thread and the reader
+constexpr std::size_t DECOMPRESS_BUFFER_SIZE = 1 << 20;
+
+
+/// Opens a file (compressed by any method supported by libsolv's solv_xfopen()) for reading.
+/// The compressed file is decompressed by a separate thread into a bounded ring buffer of `buffer_size` bytes
+/// and the returned stream reads from the buffer, so the decompression overlaps with the processing of the data
+/// (e.g. XML parsing). An uncompressed file, or any file with the zero `buffer_size`, is opened directly.
+/// Returns nullptr if the file cannot be opened.
+/// The stream must be closed by fclose(), which also stops and joins the decompressing thread.
+std::FILE * open_decompressed(const std::string & path, std::size_t buffer_size = DECOMPRESS_BUFFER_SIZE);
+
+
+}  // namespace libdnf::utils
+
+
+#endif  // LIBDNF_UTILS_DECOMPRESS_HPP
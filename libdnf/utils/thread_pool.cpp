@@ -0,0 +1,109 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "thread_pool.hpp"
+
+
+namespace libdnf::utils {
+
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto & thread : threads) {
+        thread.join();
+    }
+}
+
+
+void ThreadPool::run(std::size_t num_tasks, const std::function<void(std::size_t)> & task) {
+    std::lock_guard<std::mutex> run_lock(run_mutex);
+    std::vector<std::exception_ptr> errors(num_tasks);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (threads.size() + 1 < num_tasks) {
+        threads.emplace_back([this]() { worker(); });
+    }
+    batch_task = &task;
+    batch_errors = &errors;
+    batch_size = num_tasks;
+    next_task = 0;
+    unfinished_tasks = num_tasks;
+    task_available.notify_all();
+
+    // the calling thread helps, then waits for the tasks taken by the threads of the pool
+    while (run_next_task(lock)) {
+    }
+    batch_finished.wait(lock, [this]() { return unfinished_tasks == 0; });
+    batch_task = nullptr;
+    batch_errors = nullptr;
+    lock.unlock();
+
+    for (auto & error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+
+std::size_t ThreadPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return threads.size();
+}
+
+
+bool ThreadPool::run_next_task(std::unique_lock<std::mutex> & lock) {
+    if (!batch_task || next_task >= batch_size) {
+        return false;
+    }
+    auto idx = next_task++;
+    auto & task = *batch_task;
+    auto & errors = *batch_errors;
+    lock.unlock();
+    try {
+        task(idx);
+    } catch (...) {
+        // each task writes only its own item, the items are read after the batch finished
+        errors[idx] = std::current_exception();
+    }
+    lock.lock();
+    if (--unfinished_tasks == 0) {
+        batch_finished.notify_all();
+    }
+    return true;
+}
+
+
+void ThreadPool::worker() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        task_available.wait(lock, [this]() { return stopping || (batch_task && next_task < batch_size); });
+        if (stopping) {
+            return;
+        }
+        run_next_task(lock);
+    }
+}
+
+
+}  // namespace libdnf::utils
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_UTILS_THREAD_POOL_HPP
+#define LIBDNF_UTILS_THREAD_POOL_HPP
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf::utils {
+
+
+/// Threads reused by several batches of tasks, e.g. by the filters of the queries evaluated in parallel.
+/// The threads are started on demand by the first batch that needs them and they wait for the next batch
+/// until the pool is destroyed.
+class ThreadPool {
+public:
+    ThreadPool() = default;
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    /// Calls `task(idx)` for each `idx` in [0, `num_tasks`) and waits for all of them. The tasks are run by
+    /// the threads of the pool and by the calling thread, at most `num_tasks` at once. The pool is grown
+    /// to `num_tasks - 1` threads if it is smaller. If any task throws, the exception of the task with the lowest
+    /// `idx` is rethrown after all tasks finished. Batches run by several threads at once are serialized.
+    void run(std::size_t num_tasks, const std::function<void(std::size_t)> & task);
+
+    /// Returns the number of started threads
+    std::size_t size() const;
+
+private:
+    /// Runs the next task of the current batch, returns false if there is none. `lock` holds `mutex`,
+    /// it is released while the task runs.
+    bool run_next_task(std::unique_lock<std::mutex> & lock);
+
+    void worker();
+
+    std::mutex run_mutex;  // serializes the batches
+    mutable std::mutex mutex;
+    std::condition_variable task_available;
+    std::condition_variable batch_finished;
+    std::vector<std::thread> threads;
+    bool stopping{false};
+
+    // the current batch
+    const std::function<void(std::size_t)> * batch_task{nullptr};
+    std::vector<std::exception_ptr> * batch_errors{nullptr};
+    std::size_t batch_size{0};
+    std::size_t next_task{0};
+    std::size_t unfinished_tasks{0};
+};
+
+
+}  // namespace libdnf::utils
+
+
+#endif  // LIBDNF_UTILS_THREAD_POOL_HPP
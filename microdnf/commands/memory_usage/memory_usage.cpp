@@ -0,0 +1,155 @@
+/*
+Copyright (C) 2019-2020 Red Hat, Inc.
+
+This file is part of microdnf: https://github.com/rpm-software-management/libdnf/
+
+Microdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Microdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with microdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "memory_usage.hpp"
+
+#include "../../context.hpp"
+
+#include <libdnf-cli/progressbar/widgets/common.hpp>
+#include <libdnf/rpm/solv_query.hpp>
+#include <libdnf/rpm/solv_sack.hpp>
+#include <libsmartcols/libsmartcols.h>
+
+#include <iostream>
+
+namespace microdnf {
+
+using libdnf::cli::progressbar::format_size;
+
+// memory usage table columns
+enum {
+    COL_NAME,
+    COL_SOLVABLES,
+    COL_DEPENDENCIES,
+    COL_STRINGS,
+    COL_PRIMARY,
+    COL_FILELISTS,
+    COL_OTHER,
+    COL_PRESTO,
+    COL_UPDATEINFO,
+    COL_WHATPROVIDES,
+    COL_INDEXES,
+    COL_TOTAL
+};
+
+static struct libscols_table * create_memory_usage_table() {
+    struct libscols_table * table = scols_new_table();
+    if (isatty(1)) {
+        scols_table_enable_colors(table, 1);
+    }
+    scols_table_new_column(table, "repo id", 0.2, 0);
+    for (const char * name :
+         {"solvables",
+          "deps",
+          "strings",
+          "primary",
+          "filelists",
+          "other",
+          "presto",
+          "updateinfo",
+          "whatprovides",
+          "indexes",
+          "total"}) {
+        scols_table_new_column(table, name, 0.1, SCOLS_FL_RIGHT);
+    }
+    return table;
+}
+
+static void add_line_into_table(struct libscols_table * table, const libdnf::rpm::RepoMemoryUsage & usage) {
+    struct libscols_line * ln = scols_table_new_line(table, nullptr);
+    scols_line_set_data(ln, COL_NAME, usage.repo_id.c_str());
+    scols_line_set_data(ln, COL_SOLVABLES, format_size(static_cast<int64_t>(usage.solvables)).c_str());
+    scols_line_set_data(ln, COL_DEPENDENCIES, format_size(static_cast<int64_t>(usage.dependencies)).c_str());
+    scols_line_set_data(ln, COL_STRINGS, format_size(static_cast<int64_t>(usage.strings)).c_str());
+    scols_line_set_data(ln, COL_PRIMARY, format_size(static_cast<int64_t>(usage.main_repodata)).c_str());
+    scols_line_set_data(ln, COL_FILELISTS, format_size(static_cast<int64_t>(usage.filelists)).c_str());
+    scols_line_set_data(ln, COL_OTHER, format_size(static_cast<int64_t>(usage.other)).c_str());
+    scols_line_set_data(ln, COL_PRESTO, format_size(static_cast<int64_t>(usage.presto)).c_str());
+    scols_line_set_data(ln, COL_UPDATEINFO, format_size(static_cast<int64_t>(usage.updateinfo)).c_str());
+    scols_line_set_data(ln, COL_WHATPROVIDES, format_size(static_cast<int64_t>(usage.whatprovides)).c_str());
+    scols_line_set_data(ln, COL_INDEXES, format_size(static_cast<int64_t>(usage.libdnf_indexes)).c_str());
+    scols_line_set_data(ln, COL_TOTAL, format_size(static_cast<int64_t>(usage.get_total())).c_str());
+}
+
+static void add_shared_line_into_table(struct libscols_table * table, const char * name, std::size_t size) {
+    struct libscols_line * ln = scols_table_new_line(table, nullptr);
+    scols_line_set_data(ln, COL_NAME, name);
+    scols_line_set_data(ln, COL_TOTAL, format_size(static_cast<int64_t>(size)).c_str());
+}
+
+void CmdMemoryUsage::set_argument_parser(Context & ctx) {
+    installed_option = dynamic_cast<libdnf::OptionBool *>(
+        ctx.arg_parser.add_init_value(std::unique_ptr<libdnf::OptionBool>(new libdnf::OptionBool(false))));
+
+    auto installed = ctx.arg_parser.add_new_named_arg("installed");
+    installed->set_long_name("installed");
+    installed->set_short_description("load also the system repository (installed packages)");
+    installed->set_const_value("true");
+    installed->link_value(installed_option);
+
+    auto memory_usage = ctx.arg_parser.add_new_command("memory-usage");
+    memory_usage->set_short_description("show memory used by the loaded repositories (debug)");
+    memory_usage->set_description("");
+    memory_usage->named_args_help_header = "Optional arguments:";
+    memory_usage->parse_hook = [this, &ctx](
+                                   [[maybe_unused]] ArgumentParser::Argument * arg,
+                                   [[maybe_unused]] const char * option,
+                                   [[maybe_unused]] int argc,
+                                   [[maybe_unused]] const char * const argv[]) {
+        ctx.select_command(this);
+        return true;
+    };
+
+    memory_usage->add_named_arg(installed);
+
+    ctx.arg_parser.get_root_command()->add_command(memory_usage);
+}
+
+void CmdMemoryUsage::run(Context & ctx) {
+    auto & solv_sack = ctx.base.get_rpm_solv_sack();
+
+    if (installed_option->get_value()) {
+        solv_sack.create_system_repo(true);
+    }
+
+    auto enabled_repos = ctx.base.get_rpm_repo_sack().new_query().ifilter_enabled(true);
+    using LoadFlags = libdnf::rpm::SolvSack::LoadRepoFlags;
+    auto flags = LoadFlags::USE_FILELISTS | LoadFlags::USE_PRESTO | LoadFlags::USE_UPDATEINFO | LoadFlags::USE_OTHER;
+    ctx.load_rpm_repos(enabled_repos, flags);
+    std::cout << std::endl;
+
+    // the provides index is created by the first query, as in the other commands
+    libdnf::rpm::SolvQuery query(&solv_sack);
+    query.ifilter_provides(libdnf::sack::QueryCmp::EQ, std::vector<std::string>{"/bin/sh"});
+
+    auto usage = solv_sack.get_memory_usage();
+    auto table = create_memory_usage_table();
+    for (auto & repo_usage : usage.repos) {
+        add_line_into_table(table, repo_usage);
+    }
+    add_shared_line_into_table(table, "(string pool)", usage.string_pool);
+    add_shared_line_into_table(table, "(relations)", usage.relations);
+    add_shared_line_into_table(table, "(whatprovides)", usage.whatprovides);
+    add_shared_line_into_table(table, "(libdnf indexes)", usage.libdnf_indexes);
+    add_shared_line_into_table(table, "total", usage.get_total());
+    scols_print_table(table);
+    scols_unref_table(table);
+}
+
+}  // namespace microdnf
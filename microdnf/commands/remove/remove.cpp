@@ -68,7 +68,7 @@ void CmdRemove::run(Context & ctx) {
 
     // To search in the system repository (installed packages)
     // Creates system repository in the repo_sack and loads it into rpm::SolvSack.
-    solv_sack.create_system_repo(false);
+    solv_sack.create_system_repo(true);
 
     libdnf::rpm::PackageSet result_pset(&solv_sack);
     libdnf::rpm::SolvQuery full_solv_query(&solv_sack);
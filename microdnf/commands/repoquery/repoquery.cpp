@@ -152,7 +152,7 @@ void CmdRepoquery::run(Context & ctx) {
     // To search in the system repository (installed packages)
     if (installed_option->get_value()) {
         // Creates system repository in the repo_sack and loads it into rpm::SolvSack.
-        solv_sack.create_system_repo(false);
+        solv_sack.create_system_repo(true);
     }
 
     // To search in available repositories (available packages)
@@ -173,15 +173,16 @@ void CmdRepoquery::run(Context & ctx) {
         result_pset |= solv_query.get_package_set();
     }
 
+    using SortOrder = libdnf::rpm::PackageSet::SortOrder;
     if (info_option->get_value()) {
-        for (auto package : result_pset) {
+        result_pset.iterate_sorted(SortOrder::NEVRA, [](libdnf::rpm::Package package) {
             print_package_info(package);
             std::cout << '\n';
-        }
+        });
     } else {
-        for (auto package : result_pset) {
+        result_pset.iterate_sorted(SortOrder::NEVRA, [](libdnf::rpm::Package package) {
             std::cout << package.get_full_nevra() << '\n';
-        }
+        });
     }
 }
 
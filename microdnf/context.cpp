@@ -24,10 +24,12 @@ along with microdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <libdnf/rpm/package_set.hpp>
 #include <libdnf/rpm/transaction.hpp>
 
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -62,7 +64,9 @@ static bool userconfirm(libdnf::ConfigMain & config) {
 
 class MicrodnfRepoCB : public libdnf::rpm::RepoCB {
 public:
-    explicit MicrodnfRepoCB(libdnf::ConfigMain & config) : config(&config) {}
+    explicit MicrodnfRepoCB(libdnf::ConfigMain & config, bool show_progress = true)
+        : config(&config)
+        , show_progress(show_progress) {}
 
     void start(const char * what) override {
         progress_bar.set_description(what);
@@ -80,7 +84,7 @@ public:
     int progress([[maybe_unused]] double total_to_download, [[maybe_unused]] double downloaded) override {
         progress_bar.set_total_ticks(static_cast<int64_t>(total_to_download));
         progress_bar.set_ticks(static_cast<int64_t>(downloaded));
-        if (is_time_to_print()) {
+        if (show_progress && is_time_to_print()) {
             print_progress_bar();
         }
         return 0;
@@ -101,6 +105,8 @@ public:
         const std::string & fingerprint,
         const std::string & url,
         [[maybe_unused]] long int timestamp) override {
+        // the repositories can be loaded concurrently, only one question is asked at a time
+        std::lock_guard<std::mutex> lock(output_mutex);
         auto tmp_id = id.size() > 8 ? id.substr(id.size() - 8) : id;
         std::cout << "Importing GPG key 0x" << id << ":\n";
         std::cout << " Userid     : \"" << user_id << "\"\n";
@@ -127,8 +133,28 @@ public:
         }
     }
 
+    /// Prints the final state of the progress bar, if the repository was downloaded, once it is loaded.
+    /// Used when the progress is not shown, the caller holds `output_mutex`.
+    void print_result() {
+        if (progress_bar.get_state() != libdnf::cli::progressbar::ProgressBarState::READY) {
+            write_progress_bar();
+            end_line();
+        }
+    }
+
+    /// Serializes the output and the questions of the callbacks of the concurrently loaded repositories
+    static std::mutex output_mutex;
+
 private:
     void print_progress_bar() {
+        if (!show_progress) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(output_mutex);
+        write_progress_bar();
+    }
+
+    void write_progress_bar() {
         if (libdnf::cli::utils::tty::is_interactive()) {
             std::cout << libdnf::cli::utils::tty::clear_line;
             for (std::size_t i = 0; i < msg_lines; i++) {
@@ -155,11 +181,13 @@ private:
     static std::chrono::time_point<std::chrono::steady_clock> prev_print_time;
 
     libdnf::ConfigMain * config;
+    bool show_progress;
     libdnf::cli::progressbar::DownloadProgressBar progress_bar{-1, ""};
     std::size_t msg_lines{0};
 };
 
 std::chrono::time_point<std::chrono::steady_clock> MicrodnfRepoCB::prev_print_time = std::chrono::steady_clock::now();
+std::mutex MicrodnfRepoCB::output_mutex;
 
 void Context::load_rpm_repo(libdnf::rpm::Repo & repo) {
     //repo->set_substitutions(variables);
@@ -179,100 +207,104 @@ void Context::load_rpm_repo(libdnf::rpm::Repo & repo) {
     callback_ptr->end_line();
 }
 
-// Multithreaded. Main thread prepares (updates) repositories metadata. Second thread loads them to solvable sack.
+// Multithreaded. The metadata of the repositories are updated concurrently by RepoSack::load_all(). Then the XML
+// metadata of the repositories are parsed into solv caches by a bounded number of threads and the repositories
+// are loaded into the solv sack one by one in the order of their ids, each as soon as its cache is built.
 void Context::load_rpm_repos(libdnf::rpm::RepoQuery & repos, libdnf::rpm::SolvSack::LoadRepoFlags flags) {
-    std::atomic<bool> except{false};  // set to true if an exception occurred
-    std::exception_ptr except_ptr;    // for pass exception from thread_sack_loader to main thread,
-                                      // a default-constructed std::exception_ptr is a null pointer
+    auto & repo_sack = base.get_rpm_repo_sack();
+    auto & solv_sack = base.get_rpm_solv_sack();
 
-    std::vector<libdnf::rpm::Repo *> prepared_repos;  // array of repositories prepared to load into solv sack
-    std::mutex prepared_repos_mutex;                  // mutex for the array
-    std::condition_variable signal_prepared_repo;     // signals that next item is added into array
-    std::size_t num_repos_loaded_to_solv_sack{0};     // number of repositories already loaded into solv sack
-
-    prepared_repos.reserve(repos.size() + 1);  // optimization: preallocate memory to avoid realocations, +1 stop tag
+    std::map<libdnf::rpm::Repo *, microdnf::MicrodnfRepoCB *> callbacks;
+    for (auto & repo : repos.get_data()) {
+        // the progress bars of the concurrently updated repositories would overwrite each other,
+        // the final state of each one is printed when the repository is reported as loaded
+        auto callback = std::make_unique<microdnf::MicrodnfRepoCB>(base.get_config(), false);
+        callbacks[repo.get()] = callback.get();
+        repo->set_callbacks(std::move(callback));
+    }
 
-    // This thread loads prepared repositories into solvable sack
-    std::thread thread_sack_loader([&]() {
+    std::cout << "Updating repositories metadata and load them:" << std::endl;
+    std::vector<libdnf::rpm::Repo *> updated_repos;
+    // called in this thread in the order of the repository ids, as soon as the repositories are loaded
+    auto report_result = [&](const libdnf::rpm::RepoLoadResult & result) {
+        auto & repo = *result.repo.get();
+        std::lock_guard<std::mutex> lock(microdnf::MicrodnfRepoCB::output_mutex);
+        callbacks.at(&repo)->print_result();
+        if (!result.error) {
+            std::cout << "Repository \"" << repo.get_id() << "\" updated" << std::endl;
+            updated_repos.push_back(&repo);
+            return;
+        }
         try {
-            auto & solv_sack = base.get_rpm_solv_sack();
-            while (true) {
-                std::unique_lock<std::mutex> lock(prepared_repos_mutex);
-                while (prepared_repos.size() <= num_repos_loaded_to_solv_sack) {
-                    signal_prepared_repo.wait(lock);
-                }
-                auto repo = prepared_repos[num_repos_loaded_to_solv_sack];
-                lock.unlock();
-
-                if (!repo || except) {
-                    break;  // nullptr mark - work is done, or exception in main thread
-                }
-
-                // std::cout << "Loading repository \"" << repo->get_config()->name().get_value() << "\" into sack." << std::endl;
-                solv_sack.load_repo(*repo, flags);
-                ++num_repos_loaded_to_solv_sack;
+            std::rethrow_exception(result.error);
+        } catch (const std::runtime_error & ex) {
+            base.get_logger().warning(ex.what());
+            std::cerr << "Error: Unable to update repository \"" << repo.get_id() << "\": " << ex.what() << std::endl;
+            if (!repo.get_config()->skip_if_unavailable().get_value()) {
+                std::cerr << "Error: Unable to load repository \"" << repo.get_id()
+                          << "\" and \"skip_if_unavailable\" is disabled for it." << std::endl;
+                throw;
             }
-        } catch (std::runtime_error & ex) {
-            // The thread must not throw exceptions. Pass them to the main thread using exception_ptr.
-            except_ptr = std::current_exception();
-            except = true;
         }
-    });
-
-    // Adds information that all repos are updated (nullptr tag) and is waiting for thread_sack_loader to complete.
-    auto finish_sack_loader = [&]() {
-        {
-            std::lock_guard<std::mutex> lock(prepared_repos_mutex);
-            prepared_repos.push_back(nullptr);
-        }
-        signal_prepared_repo.notify_one();
-
-        thread_sack_loader.join();  // waits for the thread_sack_loader to finish its execution
     };
-
-    auto catch_thread_sack_loader_exceptions = [&]() {
-        try {
-            if (except) {
-                if (thread_sack_loader.joinable()) {
-                    thread_sack_loader.join();
-                }
-                std::rethrow_exception(except_ptr);
+    repo_sack.load_all(repos, base.get_config().max_parallel_downloads().get_value(), report_result);
+
+    // Each parse needs memory for a staging pool, the number of concurrent builders is limited by the number of CPUs.
+    // The builders take the repositories in the order in which they are loaded into the solv sack.
+    std::vector<std::promise<void>> caches_built(updated_repos.size());
+    std::vector<std::future<void>> cache_builders;
+    cache_builders.reserve(updated_repos.size());
+    for (auto & cache_built : caches_built) {
+        cache_builders.push_back(cache_built.get_future());
+    }
+    std::atomic<std::size_t> next_idx{0};
+    auto build_caches = [&]() {
+        for (std::size_t idx = next_idx++; idx < updated_repos.size(); idx = next_idx++) {
+            try {
+                solv_sack.build_repo_cache(*updated_repos[idx], flags);
+                caches_built[idx].set_value();
+            } catch (...) {
+                caches_built[idx].set_exception(std::current_exception());
             }
-        } catch (std::runtime_error & ex) {
-            std::cerr << "Error: Unable to load repository \""
-                      << prepared_repos[num_repos_loaded_to_solv_sack]->get_id() << "\" to solv sack" << std::endl;
-            throw;
+        }
+    };
+    std::size_t num_builders =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), updated_repos.size());
+    std::vector<std::thread> builders;
+    auto stop_builders = [&]() {
+        next_idx = updated_repos.size();
+        for (auto & builder : builders) {
+            builder.join();
         }
     };
 
-    std::cout << "Updating repositories metadata and load them:" << std::endl;
-
-    // Prepares repositories metadata for thread sack loader.
-    for (auto & repo : repos.get_data()) {
-        catch_thread_sack_loader_exceptions();
-        try {
-            load_rpm_repo(*repo.get());
-            {
-                std::lock_guard<std::mutex> lock(prepared_repos_mutex);
-                prepared_repos.push_back(repo.get());
+    std::cout << "Waiting until sack is filled..." << std::endl;
+    try {
+        for (std::size_t idx = 0; idx < num_builders; ++idx) {
+            builders.emplace_back(build_caches);
+        }
+        for (std::size_t idx = 0; idx < updated_repos.size(); ++idx) {
+            try {
+                cache_builders[idx].get();
+            } catch (const std::exception &) {
+                // load_repo() parses the metadata itself and reports the error
             }
-            signal_prepared_repo.notify_one();
-
-        } catch (const std::runtime_error & ex) {
-            if (!repo->get_config()->skip_if_unavailable().get_value()) {
-                std::cerr << "Error: Unable to load repository \"" << repo->get_id()
-                          << "\" and \"skip_if_unavailable\" is disabled for it." << std::endl;
-                except = true;
-                finish_sack_loader();
+            try {
+                solv_sack.load_repo(*updated_repos[idx], flags);
+            } catch (const std::runtime_error &) {
+                std::cerr << "Error: Unable to load repository \"" << updated_repos[idx]->get_id()
+                          << "\" to solv sack" << std::endl;
                 throw;
             }
         }
+    } catch (...) {
+        stop_builders();
+        throw;
     }
-
-    std::cout << "Waiting until sack is filled..." << std::endl;
-    finish_sack_loader();
-    catch_thread_sack_loader_exceptions();
+    stop_builders();
     std::cout << "Sack is filled." << std::endl;
+
+    repo_sack.collect_cache_garbage();
 }
 
 // Single thread version.
@@ -380,7 +412,7 @@ void download_packages(libdnf::rpm::PackageSet & package_set, const char * dest_
     if (dest_dir) {
         destination = dest_dir;
     }
-    for (auto package : package_set) {
+    package_set.iterate_sorted(libdnf::rpm::PackageSet::SortOrder::NEVRA, [&](libdnf::rpm::Package package) {
         auto repo = package.get_repo();
         auto checksum = package.get_checksum();
         if (!dest_dir) {
@@ -406,7 +438,7 @@ void download_packages(libdnf::rpm::PackageSet & package_set, const char * dest_
             pkg_download_cb_ptr);
         targets.push_back(pkg_target.get());
         targets_guard.push_back(std::move(pkg_target));
-    }
+    });
 
     std::cout << "Downloading Packages:" << std::endl;
     try {
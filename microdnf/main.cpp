@@ -25,6 +25,7 @@ along with microdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "commands/repolist/repolist.hpp"
 #include "commands/repoquery/repoquery.hpp"
 #include "commands/upgrade/upgrade.hpp"
+#include "commands/memory_usage/memory_usage.hpp"
 #include "context.hpp"
 #include "utils.hpp"
 
@@ -138,6 +139,7 @@ int main(int argc, char * argv[]) {
     context.commands.push_back(std::make_unique<microdnf::CmdRepolist>());
     context.commands.push_back(std::make_unique<microdnf::CmdRepoquery>());
     context.commands.push_back(std::make_unique<microdnf::CmdUpgrade>());
+    context.commands.push_back(std::make_unique<microdnf::CmdMemoryUsage>());
 
     // Parse command line arguments
     bool help_printed = microdnf::parse_args(context, argc, argv);
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_match_string.hpp"
+
+#include "libdnf/common/sack/match_string.hpp"
+
+#include <regex>
+#include <stdexcept>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MatchStringTest);
+
+using libdnf::sack::match_string;
+using libdnf::sack::QueryCmp;
+
+
+void MatchStringTest::test_operators() {
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::EXACT, "libdnf"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::EXACT, "libdn"));
+    CPPUNIT_ASSERT(match_string("LibDnf", QueryCmp::IEXACT, "libdnf"));
+    CPPUNIT_ASSERT(!match_string("LibDnf", QueryCmp::IEXACT, "libdn"));
+
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::CONTAINS, "bdn"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::CONTAINS, ""));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::CONTAINS, "BDN"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::ICONTAINS, "BDN"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::ICONTAINS, "dnf5"));
+
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::STARTSWITH, "lib"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::STARTSWITH, "LIB"));
+    CPPUNIT_ASSERT(!match_string("li", QueryCmp::STARTSWITH, "lib"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::ISTARTSWITH, "LIB"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::ENDSWITH, "dnf"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::ENDSWITH, "DNF"));
+    CPPUNIT_ASSERT(!match_string("nf", QueryCmp::ENDSWITH, "dnf"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::IENDSWITH, "DNF"));
+
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::GLOB, "lib*"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::GLOB, "libdnf"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::GLOB, "LIB*"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::IGLOB, "LIB*"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::IGLOB, "LIBDNF"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::GLOB, "lib@(dnf|solv)"));
+
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::REGEX, "lib.*"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::REGEX, "LIB.*"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::IREGEX, "LIB.*"));
+
+    CPPUNIT_ASSERT_THROW(match_string("libdnf", QueryCmp::GT, "lib"), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(match_string("libdnf", QueryCmp::ISNULL, "lib"), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(match_string("libdnf", QueryCmp::NOT, "lib"), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(match_string("libdnf", QueryCmp::ICASE, "lib"), std::runtime_error);
+}
+
+
+void MatchStringTest::test_negated_operators() {
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::NEQ, "libdn"));
+    CPPUNIT_ASSERT(!match_string("LibDnf", QueryCmp::NOT_IEXACT, "libdnf"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::NOT_CONTAINS, "BDN"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::NOT_ICONTAINS, "BDN"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::NOT_GLOB, "LIB*"));
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::NOT_IGLOB, "LIB*"));
+
+    // negations without their own enumerator
+    CPPUNIT_ASSERT(!match_string("libdnf", QueryCmp::NOT | QueryCmp::STARTSWITH, "lib"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::NOT | QueryCmp::IENDSWITH, "lib"));
+    CPPUNIT_ASSERT(match_string("libdnf", QueryCmp::NOT | QueryCmp::REGEX, "LIB.*"));
+}
+
+
+void MatchStringTest::test_string_matcher() {
+    libdnf::sack::StringMatcher matcher(QueryCmp::IREGEX, std::vector<std::string>{"^lib.*", "solv"});
+    CPPUNIT_ASSERT(matcher.match("LIBDNF"));
+    CPPUNIT_ASSERT(matcher.match("Solv"));
+    CPPUNIT_ASSERT(!matcher.match("dnf"));
+    CPPUNIT_ASSERT(matcher.match(std::vector<std::string>{"dnf", "libsolv"}));
+    CPPUNIT_ASSERT(!matcher.match(std::vector<std::string>{"dnf", "rpm"}));
+    CPPUNIT_ASSERT(!matcher.match(static_cast<const char *>(nullptr)));
+
+    libdnf::sack::StringMatcher not_contains(QueryCmp::NOT_CONTAINS, "dnf");
+    CPPUNIT_ASSERT(not_contains.match("rpm"));
+    CPPUNIT_ASSERT(!not_contains.match("libdnf"));
+    CPPUNIT_ASSERT(not_contains.match(static_cast<const char *>(nullptr)));
+
+    // invalid patterns are reported when the matcher is created, not when a value is matched
+    CPPUNIT_ASSERT_THROW(libdnf::sack::StringMatcher(QueryCmp::REGEX, "lib("), std::regex_error);
+}
@@ -21,6 +21,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/common/sack/query.hpp"
 
+#include <stdexcept>
+#include <vector>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(QueryTest);
 
 class Item {
@@ -103,3 +106,108 @@ void QueryTest::test_query_basics() {
     CPPUNIT_ASSERT_EQUAL(q1.size(), static_cast<size_t>(1));
     CPPUNIT_ASSERT((q1 == libdnf::Set<Item>{{false, 6, "item6"}}));
 }
+
+
+void QueryTest::test_query_sorted_vector() {
+    using Items = libdnf::SortedVectorSet<Item>;
+    libdnf::sack::Query<Item, std::vector<Item>> q;
+    std::vector<Item> items{{true, 10, "item10"}, {false, 6, "item6"}, {true, 4, "item4"}, {false, 6, "item6"}};
+    q.add(items.begin(), items.end());
+    CPPUNIT_ASSERT_EQUAL(q.size(), static_cast<size_t>(3));
+    CPPUNIT_ASSERT((q.list() == std::vector<Item>{{true, 4, "item4"}, {false, 6, "item6"}, {true, 10, "item10"}}));
+
+    // chained filters keep the vector sorted
+    auto q1 = q;
+    q1.ifilter([](const Item & obj) { return obj.enabled; }, libdnf::sack::QueryCmp::EQ, true);
+    CPPUNIT_ASSERT((q1 == Items{{true, 4, "item4"}, {true, 10, "item10"}}));
+    auto id = [](const Item & obj) { return static_cast<int64_t>(obj.id); };
+    q1.ifilter(id, libdnf::sack::QueryCmp::GT, static_cast<int64_t>(5));
+    CPPUNIT_ASSERT((q1 == Items{{true, 10, "item10"}}));
+
+    // sets with different containers can be compared
+    CPPUNIT_ASSERT((q == libdnf::Set<Item>{{true, 4, "item4"}, {false, 6, "item6"}, {true, 10, "item10"}}));
+}
+
+
+namespace {
+
+int enabled_calls = 0;
+int name_calls = 0;
+
+bool counted_enabled(const Item & obj) {
+    ++enabled_calls;
+    return obj.enabled;
+}
+
+std::string counted_name(const Item & obj) {
+    ++name_calls;
+    return obj.name;
+}
+
+bool id_throws = false;
+
+int64_t throwing_id(const Item & obj) {
+    if (id_throws && obj.id == 10) {
+        throw std::runtime_error("cannot get id");
+    }
+    return obj.id;
+}
+
+}  // namespace
+
+
+void QueryTest::test_query_deferred_filters() {
+    using Cmp = libdnf::sack::QueryCmp;
+    libdnf::sack::Query<Item, std::vector<Item>> q;
+    std::vector<Item> items{{true, 4, "item4"}, {false, 6, "item6"}, {true, 10, "item10"}};
+    q.add(items.begin(), items.end());
+
+    // chained filters are not evaluated until the query is accessed
+    enabled_calls = 0;
+    name_calls = 0;
+    q.ifilter(counted_enabled, Cmp::EQ, true);
+    q.ifilter(counted_name, Cmp::NOT_GLOB, "item1*");
+    CPPUNIT_ASSERT_EQUAL(0, enabled_calls);
+    CPPUNIT_ASSERT_EQUAL(0, name_calls);
+
+    // then they are applied in a single pass, the next filter sees only the objects passing the previous ones
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), q.size());
+    CPPUNIT_ASSERT_EQUAL(3, enabled_calls);
+    CPPUNIT_ASSERT_EQUAL(2, name_calls);
+    CPPUNIT_ASSERT((q == libdnf::SortedVectorSet<Item>{{true, 4, "item4"}}));
+    CPPUNIT_ASSERT_EQUAL(3, enabled_calls);
+
+    // copies and set operations see the filtered objects
+    TestQuery q1(libdnf::Set<Item>{{true, 4, "item4"}, {false, 6, "item6"}, {true, 10, "item10"}});
+    q1.ifilter_enabled(false);
+    auto q2 = q1;
+    CPPUNIT_ASSERT((q2 == libdnf::Set<Item>{{false, 6, "item6"}}));
+    libdnf::Set<Item> all{{true, 4, "item4"}, {false, 6, "item6"}, {true, 10, "item10"}};
+    q2.ifilter_id(Cmp::GT, 4);
+    CPPUNIT_ASSERT(((all - q2) == libdnf::Set<Item>{{true, 4, "item4"}, {true, 10, "item10"}}));
+
+    // objects added after filtering are not filtered
+    q2.ifilter_name(Cmp::EQ, "item4");
+    q2.add({true, 4, "item4"});
+    q2.add({true, 10, "item10"});
+    CPPUNIT_ASSERT((q2 == libdnf::Set<Item>{{true, 4, "item4"}, {true, 10, "item10"}}));
+
+    // an invalid comparison is reported when the filter is added
+    CPPUNIT_ASSERT_THROW(q2.ifilter_id(Cmp::GLOB, 4), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(q2.ifilter_name(Cmp::LT, "item"), std::runtime_error);
+
+    // a throwing getter leaves the data and the filters unchanged, both for the sorted vector and for std::set,
+    // the filters are applied again on the next access
+    libdnf::sack::Query<Item, std::vector<Item>> q3;
+    q3.add(items.begin(), items.end());
+    q3.ifilter(throwing_id, Cmp::NEQ, static_cast<int64_t>(4));
+    libdnf::sack::Query<Item> q4;
+    q4.add(items.begin(), items.end());
+    q4.ifilter(throwing_id, Cmp::NEQ, static_cast<int64_t>(4));
+    id_throws = true;
+    CPPUNIT_ASSERT_THROW(q3.size(), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(q4.size(), std::runtime_error);
+    id_throws = false;
+    CPPUNIT_ASSERT((q3 == libdnf::SortedVectorSet<Item>{{false, 6, "item6"}, {true, 10, "item10"}}));
+    CPPUNIT_ASSERT((q4 == libdnf::Set<Item>{{false, 6, "item6"}, {true, 10, "item10"}}));
+}
@@ -28,6 +28,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class QueryTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(QueryTest);
     CPPUNIT_TEST(test_query_basics);
+    CPPUNIT_TEST(test_query_sorted_vector);
+    CPPUNIT_TEST(test_query_deferred_filters);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -35,6 +37,8 @@ public:
     void tearDown() override;
 
     void test_query_basics();
+    void test_query_sorted_vector();
+    void test_query_deferred_filters();
 };
 
 #endif
@@ -22,10 +22,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/base/base.hpp"
 #include "libdnf/logger/stream_logger.hpp"
 #include "libdnf/rpm/repo_sack.hpp"
+#include "libdnf/rpm/solv_query.hpp"
 #include "libdnf/rpm/solv_sack.hpp"
 
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RepoTest);
 
@@ -40,6 +45,26 @@ void RepoTest::tearDown() {
 }
 
 
+void RepoTest::configure_base(libdnf::Base & base, const std::string & installroot) {
+    std::filesystem::create_directories(temp->get_path() / installroot);
+    base.get_config().installroot().set(libdnf::Option::Priority::RUNTIME, temp->get_path() / installroot);
+    base.get_config().cachedir().set(libdnf::Option::Priority::RUNTIME, temp->get_path() / "cache");
+}
+
+
+libdnf::rpm::RepoWeakPtr RepoTest::add_test_repo(
+    libdnf::rpm::RepoSack & repo_sack, const std::string & repo_id, bool load) {
+    auto repo = repo_sack.new_repo(repo_id);
+    std::filesystem::path repo_path = PROJECT_SOURCE_DIR "/test/libdnf/rpm/repos-data/";
+    repo_path /= repo_id;
+    repo->get_config()->baseurl().set(libdnf::Option::Priority::RUNTIME, "file://" + repo_path.native());
+    if (load) {
+        repo->load();
+    }
+    return repo;
+}
+
+
 using LoadFlags = libdnf::rpm::SolvSack::LoadRepoFlags;
 
 
@@ -87,3 +112,390 @@ void RepoTest::test_repo_basics() {
         log_router.error(ex.what());
     }
 }
+
+
+void RepoTest::test_build_repo_cache() {
+    libdnf::Base base;
+    auto cachedir = temp->get_path() / "cache";
+    configure_base(base);
+
+    libdnf::rpm::RepoSack repo_sack(base);
+    libdnf::rpm::SolvSack sack(base);
+
+    std::vector<libdnf::rpm::RepoWeakPtr> repos;
+    for (const char * repo_id : {"dnf-ci-fedora", "package-test-baseurl"}) {
+        repos.push_back(add_test_repo(repo_sack, repo_id));
+    }
+
+    // builds the solv caches of both repositories concurrently
+    auto flags = LoadFlags::USE_FILELISTS | LoadFlags::USE_OTHER;
+    std::vector<std::thread> builders;
+    for (auto & repo : repos) {
+        builders.emplace_back([&sack, repo = repo.get(), flags]() { sack.build_repo_cache(*repo, flags); });
+    }
+    for (auto & builder : builders) {
+        builder.join();
+    }
+    for (auto & repo : repos) {
+        CPPUNIT_ASSERT(std::filesystem::exists(cachedir / (repo->get_id() + ".solv")));
+        // the extensions loaded on demand are not parsed in advance
+        CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / (repo->get_id() + "-filenames.solvx")));
+        CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / (repo->get_id() + "-other.solvx")));
+        // the repomd checksum is stored, repomd is not read again while it does not change
+        CPPUNIT_ASSERT(std::filesystem::exists(cachedir / (repo->get_id() + "-repomd.stat")));
+    }
+
+    // the sack is not modified until the repositories are loaded from the caches
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), libdnf::rpm::SolvQuery(&sack).size());
+    for (auto & repo : repos) {
+        sack.load_repo(*repo.get(), flags);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+    libdnf::rpm::SolvQuery query(&sack);
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+    // the file lists were loaded and cached by the query, the changelogs are still not needed
+    CPPUNIT_ASSERT(std::filesystem::exists(cachedir / "dnf-ci-fedora-filenames.solvx"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / "dnf-ci-fedora-other.solvx"));
+}
+
+
+void RepoTest::test_load_repo_lazy_extensions() {
+    libdnf::Base base;
+    auto cachedir = temp->get_path() / "cache";
+    configure_base(base);
+
+    libdnf::rpm::RepoSack repo_sack(base);
+    libdnf::rpm::SolvSack sack(base);
+
+    auto repo = add_test_repo(repo_sack, "dnf-ci-fedora");
+    sack.load_repo(*repo.get(), LoadFlags::USE_FILELISTS | LoadFlags::USE_OTHER);
+
+    // the extensions are not parsed (and cached) until their data are needed
+    auto filenames_cache = cachedir / "dnf-ci-fedora-filenames.solvx";
+    CPPUNIT_ASSERT(std::filesystem::exists(cachedir / "dnf-ci-fedora.solv"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(filenames_cache));
+    CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / "dnf-ci-fedora-other.solvx"));
+
+    libdnf::rpm::SolvQuery query(&sack);
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+    CPPUNIT_ASSERT(std::filesystem::exists(filenames_cache));
+    CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / "dnf-ci-fedora-other.solvx"));
+}
+
+
+void RepoTest::test_sack_snapshot() {
+    auto cachedir = temp->get_path() / "cache";
+    auto snapshot_path = (cachedir / "sack.snapshot").native();
+    auto flags = LoadFlags::USE_FILELISTS;
+
+    // loads the repositories into a new sack, from the snapshot if it can be used
+    auto load_sack = [&](libdnf::Base & base, libdnf::rpm::SolvSack & sack, LoadFlags load_flags, bool from_snapshot) {
+        configure_base(base);
+        std::vector<libdnf::rpm::Repo *> repos;
+        for (const char * repo_id : {"dnf-ci-fedora", "package-test-baseurl"}) {
+            repos.push_back(add_test_repo(base.get_rpm_repo_sack(), repo_id).get());
+        }
+        if (from_snapshot) {
+            return sack.load_snapshot(snapshot_path, repos, load_flags, false);
+        }
+        for (auto repo : repos) {
+            sack.load_repo(*repo, load_flags);
+        }
+        return true;
+    };
+
+    libdnf::Base base;
+    libdnf::rpm::SolvSack sack(base);
+    load_sack(base, sack, flags, false);
+    sack.write_snapshot(snapshot_path);
+    CPPUNIT_ASSERT(std::filesystem::exists(snapshot_path));
+
+    libdnf::Base restored_base;
+    libdnf::rpm::SolvSack restored_sack(restored_base);
+    CPPUNIT_ASSERT(load_sack(restored_base, restored_sack, flags, true));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&restored_sack).size());
+    libdnf::rpm::SolvQuery query(&restored_sack);
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+
+    // the snapshot is not used for different load flags
+    libdnf::Base other_base;
+    libdnf::rpm::SolvSack other_sack(other_base);
+    CPPUNIT_ASSERT(!load_sack(other_base, other_sack, LoadFlags::NONE, true));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), libdnf::rpm::SolvQuery(&other_sack).size());
+}
+
+
+void RepoTest::test_zstd_solv_cache() {
+    auto cachedir = temp->get_path() / "cache";
+    auto load_repo = [&](libdnf::Base & base, libdnf::rpm::SolvSack & sack) {
+        configure_base(base);
+        auto repo = add_test_repo(base.get_rpm_repo_sack(), "dnf-ci-fedora");
+        sack.load_repo(*repo.get(), LoadFlags::USE_FILELISTS);
+        // loads (and caches) the filelists
+        libdnf::rpm::SolvQuery query(&sack);
+        query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+        return libdnf::rpm::SolvQuery(&sack).size();
+    };
+    auto is_zstd_file = [](const std::filesystem::path & path) {
+        std::ifstream file(path, std::ios::binary);
+        char magic[4]{};
+        file.read(magic, sizeof(magic));
+        return std::string(magic, sizeof(magic)) == "\x28\xb5\x2f\xfd";
+    };
+
+    libdnf::Base base;
+    base.get_config().solv_cache_compression().set(libdnf::Option::Priority::RUNTIME, "zstd");
+    libdnf::rpm::SolvSack sack(base);
+    auto size = load_repo(base, sack);
+    CPPUNIT_ASSERT(is_zstd_file(cachedir / "dnf-ci-fedora.solv"));
+    CPPUNIT_ASSERT(is_zstd_file(cachedir / "dnf-ci-fedora-filenames.solvx"));
+
+    // the compressed cache is detected and used also with the compression disabled, it is not written again
+    libdnf::Base other_base;
+    libdnf::rpm::SolvSack other_sack(other_base);
+    CPPUNIT_ASSERT_EQUAL(size, load_repo(other_base, other_sack));
+    CPPUNIT_ASSERT(is_zstd_file(cachedir / "dnf-ci-fedora.solv"));
+    CPPUNIT_ASSERT(is_zstd_file(cachedir / "dnf-ci-fedora-filenames.solvx"));
+}
+
+
+void RepoTest::test_unload_repo() {
+    libdnf::Base base;
+    configure_base(base);
+
+    libdnf::rpm::RepoSack repo_sack(base);
+    libdnf::rpm::SolvSack sack(base);
+
+    std::vector<libdnf::rpm::RepoWeakPtr> repos;
+    for (const char * repo_id : {"dnf-ci-fedora", "package-test-baseurl"}) {
+        auto repo = add_test_repo(repo_sack, repo_id);
+        sack.load_repo(*repo.get(), LoadFlags::USE_FILELISTS);
+        repos.push_back(repo);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+    auto sack_weak_ptr = sack.get_weak_ptr();
+
+    // the package sets of the sack are invalidated
+    sack.unload_repo(*repos[0].get());
+    CPPUNIT_ASSERT(!sack_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), libdnf::rpm::SolvQuery(&sack).size());
+    CPPUNIT_ASSERT_THROW(sack.unload_repo(*repos[0].get()), libdnf::LogicError);
+
+    sack.load_repo(*repos[0].get(), LoadFlags::USE_FILELISTS);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+    libdnf::rpm::SolvQuery query(&sack);
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+
+    auto repo_usage = [&sack](const std::string & repo_id) {
+        for (auto & usage : sack.get_memory_usage().repos) {
+            if (usage.repo_id == repo_id) {
+                return usage;
+            }
+        }
+        return libdnf::rpm::RepoMemoryUsage();
+    };
+    auto filelists_usage = [&repo_usage](const std::string & repo_id) { return repo_usage(repo_id).filelists; };
+    CPPUNIT_ASSERT(filelists_usage("dnf-ci-fedora") > 0);
+
+    // the provides index is attributed to the repositories of the providers
+    libdnf::rpm::SolvQuery query_provides(&sack);
+    query_provides.ifilter_provides(libdnf::sack::QueryCmp::EQ, std::vector<std::string>{"wget"});
+    CPPUNIT_ASSERT(repo_usage("package-test-baseurl").whatprovides > 0);
+    CPPUNIT_ASSERT(repo_usage("dnf-ci-fedora").whatprovides > repo_usage("package-test-baseurl").whatprovides);
+
+    // the packages stay, only the file lists are gone, the files from primary are still known
+    sack.drop_repo_extensions(*repos[0].get(), LoadFlags::USE_FILELISTS);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), filelists_usage("dnf-ci-fedora"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+    libdnf::rpm::SolvQuery query_dropped(&sack);
+    query_dropped.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query_dropped.size());
+    CPPUNIT_ASSERT_THROW(
+        sack.drop_repo_extensions(*repos[0].get(), LoadFlags::USE_UPDATEINFO), libdnf::LogicError);
+}
+
+
+void RepoTest::test_shared_repo_cache() {
+    auto cache = std::make_shared<libdnf::rpm::SharedRepoCache>();
+    auto cachedir = temp->get_path() / "cache";
+
+    // each Base has its own installroot, the repositories are the same
+    auto load_sack = [&](libdnf::Base & base, libdnf::rpm::SolvSack & sack, const std::string & installroot) {
+        configure_base(base, installroot);
+        sack.set_shared_repo_cache(cache);
+        for (const char * repo_id : {"dnf-ci-fedora", "package-test-baseurl"}) {
+            auto repo = add_test_repo(base.get_rpm_repo_sack(), repo_id);
+            sack.load_repo(*repo.get(), LoadFlags::USE_FILELISTS);
+        }
+    };
+
+    libdnf::Base base;
+    libdnf::rpm::SolvSack sack(base);
+    load_sack(base, sack, "installroot1");
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), cache->size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+
+    // the main solv cache files are not read anymore, the data come from the shared cache
+    std::filesystem::remove(cachedir / "dnf-ci-fedora.solv");
+    std::filesystem::remove(cachedir / "package-test-baseurl.solv");
+    libdnf::Base other_base;
+    libdnf::rpm::SolvSack other_sack(other_base);
+    load_sack(other_base, other_sack, "installroot2");
+    CPPUNIT_ASSERT(!std::filesystem::exists(cachedir / "dnf-ci-fedora.solv"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&other_sack).size());
+    libdnf::rpm::SolvQuery query(&other_sack);
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+
+    // the loaded data stay valid after the cache is cleared
+    cache->clear();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), cache->size());
+    libdnf::rpm::SolvQuery query_name(&other_sack);
+    query_name.ifilter_name(libdnf::sack::QueryCmp::EQ, {"wget"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), query_name.size());
+}
+
+
+void RepoTest::test_fork_sack() {
+    libdnf::Base base;
+    configure_base(base);
+
+    libdnf::rpm::RepoSack repo_sack(base);
+    libdnf::rpm::SolvSack sack(base);
+
+    std::vector<libdnf::rpm::RepoWeakPtr> repos;
+    for (const char * repo_id : {"dnf-ci-fedora", "package-test-baseurl"}) {
+        auto repo = add_test_repo(repo_sack, repo_id);
+        sack.load_repo(*repo.get(), LoadFlags::USE_FILELISTS);
+        repos.push_back(repo);
+    }
+    sack.create_system_repo(false);
+    auto sack_weak_ptr = sack.get_weak_ptr();
+
+    auto child = sack.fork();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(child.get()).size());
+    libdnf::rpm::SolvQuery query(child.get());
+    query.ifilter_file(libdnf::sack::QueryCmp::EQ, {"/etc/ld.so.conf"});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), query.size());
+
+    // the repository is removed from the child only
+    child->unload_repo(*repos[0].get());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), libdnf::rpm::SolvQuery(child.get()).size());
+    CPPUNIT_ASSERT_THROW(child->unload_repo(*repos[0].get()), libdnf::LogicError);
+    CPPUNIT_ASSERT(sack_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+
+    // the copied data are reused by the next fork, also a child can be forked
+    auto other_child = sack.fork();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(292), libdnf::rpm::SolvQuery(other_child.get()).size());
+    auto grandchild = child->fork();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), libdnf::rpm::SolvQuery(grandchild.get()).size());
+    grandchild->unload_repo(*repos[1].get());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), libdnf::rpm::SolvQuery(grandchild.get()).size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), libdnf::rpm::SolvQuery(child.get()).size());
+}
+
+
+void RepoTest::test_collect_cache_garbage() {
+    auto cachedir = temp->get_path() / "cache";
+    libdnf::Base base;
+    configure_base(base);
+
+    libdnf::rpm::RepoSack & repo_sack = base.get_rpm_repo_sack();
+    libdnf::rpm::SolvSack sack(base);
+    auto repo = add_test_repo(repo_sack, "dnf-ci-fedora");
+    sack.load_repo(*repo.get(), LoadFlags::NONE);
+    CPPUNIT_ASSERT(std::filesystem::exists(cachedir / "dnf-ci-fedora.solv"));
+
+    // caches of a repository which is not configured anymore, and a file unknown to libdnf
+    auto create_file = [](const std::filesystem::path & path) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << "data";
+    };
+    auto stale_solv = cachedir / "removed-repo.solv";
+    auto stale_package = cachedir / "removed-repo-0123456789abcdef" / "packages" / "removed-1.0-1.noarch.rpm";
+    auto unknown_file = cachedir / "unknown.txt";
+    create_file(stale_solv);
+    create_file(stale_package);
+    create_file(unknown_file);
+
+    // metadata not used by the loaded repository, and metadata of an enabled repository which was not loaded
+    // (e.g. skipped as unavailable), its current metadata files are not known
+    auto old_metadata = std::filesystem::path(repo->get_cachedir()) / "repodata" / "old-primary.xml.gz";
+    create_file(old_metadata);
+    auto unloaded_repo = add_test_repo(repo_sack, "unloaded-repo", false);
+    auto unloaded_metadata = std::filesystem::path(unloaded_repo->get_cachedir()) / "repodata" / "repomd.xml";
+    create_file(unloaded_metadata);
+
+    // nothing is done without limits
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(0), repo_sack.collect_cache_garbage(true));
+    CPPUNIT_ASSERT(std::filesystem::exists(stale_solv));
+
+    // the files not needed by the enabled repository are removed to fit the limit
+    base.get_config().cache_size_limit().set(libdnf::Option::Priority::RUNTIME, 1);
+    CPPUNIT_ASSERT(repo_sack.collect_cache_garbage() > 0);
+    CPPUNIT_ASSERT(!std::filesystem::exists(stale_solv));
+    CPPUNIT_ASSERT(!std::filesystem::exists(stale_package.parent_path().parent_path()));
+    CPPUNIT_ASSERT(std::filesystem::exists(cachedir / "dnf-ci-fedora.solv"));
+    CPPUNIT_ASSERT(std::filesystem::exists(unknown_file));
+    CPPUNIT_ASSERT(!std::filesystem::exists(old_metadata));
+    CPPUNIT_ASSERT(std::filesystem::exists(unloaded_metadata));
+
+    // the cachedir is not scanned again within the "cache_gc_interval"
+    create_file(stale_solv);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(0), repo_sack.collect_cache_garbage());
+    CPPUNIT_ASSERT(std::filesystem::exists(stale_solv));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(4), repo_sack.collect_cache_garbage(true));
+    CPPUNIT_ASSERT(!std::filesystem::exists(stale_solv));
+
+    // with the "never" interval only the forced collection scans the cachedir, even without a time stamp
+    base.get_config().cache_gc_interval().set(libdnf::Option::Priority::RUNTIME, "never");
+    create_file(stale_solv);
+    std::filesystem::remove(cachedir / "cache-gc.stamp");
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(0), repo_sack.collect_cache_garbage());
+    CPPUNIT_ASSERT(std::filesystem::exists(stale_solv));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(4), repo_sack.collect_cache_garbage(true));
+    CPPUNIT_ASSERT(!std::filesystem::exists(stale_solv));
+}
+
+
+void RepoTest::test_load_all() {
+    libdnf::Base base;
+    configure_base(base);
+
+    libdnf::rpm::RepoSack & repo_sack = base.get_rpm_repo_sack();
+    // created in reverse order to check that the results are sorted by the repository id
+    for (const char * repo_id : {"package-test-baseurl", "missing-repo", "dnf-ci-fedora"}) {
+        add_test_repo(repo_sack, repo_id, false);
+    }
+    // only the requested repositories are loaded
+    repo_sack.new_repo("not-requested");
+    auto repos = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::NEQ, "not-requested");
+
+    // the results are reported in the calling thread in the order of the returned results
+    std::vector<std::string> reported_ids;
+    auto thread_id = std::this_thread::get_id();
+    auto results = repo_sack.load_all(repos, 2, [&](const libdnf::rpm::RepoLoadResult & result) {
+        CPPUNIT_ASSERT(std::this_thread::get_id() == thread_id);
+        reported_ids.push_back(result.repo->get_id());
+    });
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), results.size());
+    CPPUNIT_ASSERT((std::vector<std::string>{"dnf-ci-fedora", "missing-repo", "package-test-baseurl"}) == reported_ids);
+    CPPUNIT_ASSERT_EQUAL(std::string("dnf-ci-fedora"), results[0].repo->get_id());
+    CPPUNIT_ASSERT_EQUAL(std::string("missing-repo"), results[1].repo->get_id());
+    CPPUNIT_ASSERT_EQUAL(std::string("package-test-baseurl"), results[2].repo->get_id());
+    CPPUNIT_ASSERT(!results[0].error);
+    CPPUNIT_ASSERT(results[1].error);
+    CPPUNIT_ASSERT(!results[2].error);
+
+    // the loaded repositories can be used
+    libdnf::rpm::SolvSack & sack = base.get_rpm_solv_sack();
+    sack.load_repo(*results[0].repo.get(), LoadFlags::NONE);
+    sack.load_repo(*results[2].repo.get(), LoadFlags::NONE);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(292), libdnf::rpm::SolvQuery(&sack).size());
+}
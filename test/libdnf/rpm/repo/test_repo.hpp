@@ -21,15 +21,28 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF_TEST_REPO_REPO_HPP
 
 
+#include "libdnf/base/base.hpp"
+#include "libdnf/rpm/repo_sack.hpp"
 #include "libdnf/utils/temp.hpp"
 
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <string>
+
 
 class RepoTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(RepoTest);
     CPPUNIT_TEST(test_repo_basics);
+    CPPUNIT_TEST(test_build_repo_cache);
+    CPPUNIT_TEST(test_load_repo_lazy_extensions);
+    CPPUNIT_TEST(test_sack_snapshot);
+    CPPUNIT_TEST(test_zstd_solv_cache);
+    CPPUNIT_TEST(test_unload_repo);
+    CPPUNIT_TEST(test_shared_repo_cache);
+    CPPUNIT_TEST(test_fork_sack);
+    CPPUNIT_TEST(test_collect_cache_garbage);
+    CPPUNIT_TEST(test_load_all);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,8 +50,25 @@ public:
     void tearDown() override;
 
     void test_repo_basics();
+    void test_build_repo_cache();
+    void test_load_repo_lazy_extensions();
+    void test_sack_snapshot();
+    void test_zstd_solv_cache();
+    void test_unload_repo();
+    void test_shared_repo_cache();
+    void test_fork_sack();
+    void test_collect_cache_garbage();
+    void test_load_all();
 
 private:
+    /// Sets the installroot (created in the temp directory) and the cachedir of the `base` to the temp directory.
+    void configure_base(libdnf::Base & base, const std::string & installroot = "installroot");
+
+    /// Creates a repository with the baseurl pointing to the "repos-data/<repo_id>" test data directory.
+    /// The repository metadata are loaded if `load` is true.
+    libdnf::rpm::RepoWeakPtr add_test_repo(
+        libdnf::rpm::RepoSack & repo_sack, const std::string & repo_id, bool load = true);
+
     libdnf::utils::TempDir * temp;
 };
 
@@ -21,8 +21,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "test_package_set.hpp"
 
 #include "libdnf/rpm/package.hpp"
+#include "libdnf/rpm/solv_query.hpp"
 
 #include <filesystem>
+#include <string>
 #include <vector>
 
 
@@ -183,3 +185,31 @@ void RpmPackageSetTest::test_iterator() {
     }
     CPPUNIT_ASSERT(result == expected);
 }
+
+
+void RpmPackageSetTest::test_iterate_sorted() {
+    libdnf::rpm::SolvQuery query(sack.get());
+    std::vector<std::string> names{"wget", "lz4", "dwm", "CQRlib"};
+    query.ifilter_name(libdnf::sack::QueryCmp::EQ, names);
+
+    std::vector<std::string> expected{
+        "CQRlib-1.1.1-4.fc29.src",
+        "CQRlib-1.1.1-4.fc29.x86_64",
+        "dwm-6.1-1.src",
+        "dwm-6.1-1.x86_64",
+        "lz4-1.7.5-2.fc26.i686",
+        "lz4-1.7.5-2.fc26.src",
+        "lz4-1.7.5-2.fc26.x86_64",
+        "wget-1.19.5-5.fc29.src",
+        "wget-1.19.5-5.fc29.x86_64"};
+    std::vector<std::string> result;
+    query.get_package_set().iterate_sorted(
+        libdnf::rpm::PackageSet::SortOrder::NEVRA,
+        [&result](libdnf::rpm::Package pkg) { result.push_back(pkg.get_nevra()); });
+    CPPUNIT_ASSERT(result == expected);
+
+    // an empty set visits nothing
+    libdnf::rpm::PackageSet empty_set(sack.get());
+    empty_set.iterate_sorted(
+        libdnf::rpm::PackageSet::SortOrder::NEVRA, [](libdnf::rpm::Package) { CPPUNIT_FAIL("unexpected package"); });
+}
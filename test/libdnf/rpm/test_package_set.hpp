@@ -42,6 +42,7 @@ class RpmPackageSetTest : public RepoFixture {
     CPPUNIT_TEST(test_intersection);
     CPPUNIT_TEST(test_difference);
     CPPUNIT_TEST(test_iterator);
+    CPPUNIT_TEST(test_iterate_sorted);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -61,6 +62,7 @@ public:
     void test_difference();
 
     void test_iterator();
+    void test_iterate_sorted();
 
 
 private:
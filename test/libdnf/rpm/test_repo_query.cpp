@@ -68,3 +68,39 @@ void RepoQueryTest::test_query_basics() {
     repo_query1 = repo_sack.new_query().ifilter_local(false);
     CPPUNIT_ASSERT((repo_query1 == libdnf::Set{repo2, repo1_updates, repo2_updates}));
 }
+
+
+void RepoQueryTest::test_ifilter_id_indexed() {
+    libdnf::Base base;
+    libdnf::rpm::RepoSack repo_sack(base);
+
+    auto repo1 = repo_sack.new_repo("repo1");
+    auto repo1_upper = repo_sack.new_repo("REPO1");
+    auto repo2 = repo_sack.new_repo("repo2");
+    repo1->enable();
+    repo1_upper->disable();
+    repo2->enable();
+
+    // EQ and IEXACT filters are resolved using the id index of the sack
+    auto repo_query = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::EQ, "repo1");
+    CPPUNIT_ASSERT((repo_query == libdnf::Set{repo1}));
+    repo_query = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::IEXACT, "Repo1");
+    CPPUNIT_ASSERT((repo_query == libdnf::Set{repo1, repo1_upper}));
+    std::vector<std::string> ids{"repo2", "repo3"};
+    repo_query = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::EQ, ids);
+    CPPUNIT_ASSERT((repo_query == libdnf::Set{repo2}));
+    repo_query = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::EQ, "repo3");
+    CPPUNIT_ASSERT(repo_query.empty());
+
+    // the index lookup keeps only the repositories already in the query
+    repo_query = repo_sack.new_query().ifilter_enabled(true).ifilter_id(libdnf::sack::QueryCmp::IEXACT, "repo1");
+    CPPUNIT_ASSERT((repo_query == libdnf::Set{repo1}));
+
+    // repositories added after the query was created are not added to it
+    repo_query = repo_sack.new_query();
+    auto repo3 = repo_sack.new_repo("repo3");
+    repo_query.ifilter_id(libdnf::sack::QueryCmp::EQ, "repo3");
+    CPPUNIT_ASSERT(repo_query.empty());
+    repo_query = repo_sack.new_query().ifilter_id(libdnf::sack::QueryCmp::EQ, "repo3");
+    CPPUNIT_ASSERT((repo_query == libdnf::Set{repo3}));
+}
@@ -28,6 +28,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 class RepoQueryTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(RepoQueryTest);
     CPPUNIT_TEST(test_query_basics);
+    CPPUNIT_TEST(test_ifilter_id_indexed);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -35,6 +36,7 @@ public:
     void tearDown() override;
 
     void test_query_basics();
+    void test_ifilter_id_indexed();
 };
 
 #endif
@@ -229,6 +229,61 @@ void RpmSolvQueryTest::test_ifilter_nevra() {
     }
 }
 
+void RpmSolvQueryTest::test_ifilter_epoch() {
+    std::set<std::string> nevras{"nodejs-1:5.12.1-1.fc29.src",
+                                 "nodejs-1:5.12.1-1.fc29.x86_64",
+                                 "nodejs-devel-1:5.12.1-1.fc29.x86_64",
+                                 "nodejs-docs-1:5.12.1-1.fc29.noarch",
+                                 "npm-1:5.12.1-1.fc29.x86_64"};
+
+    {
+        // Test QueryCmp::EQ - number
+        libdnf::rpm::SolvQuery query(sack.get());
+        std::vector<unsigned long> epoch{1};
+        query.ifilter_epoch(libdnf::sack::QueryCmp::EQ, epoch);
+        CPPUNIT_ASSERT_EQUAL(5lu, query.size());
+        auto pset = query.get_package_set();
+        for (auto pkg : pset) {
+            CPPUNIT_ASSERT(nevras.find(pkg.get_full_nevra()) != nevras.end());
+        }
+    }
+
+    {
+        // Test QueryCmp::GT and QueryCmp::LTE - number
+        libdnf::rpm::SolvQuery query_gt(sack.get());
+        std::vector<unsigned long> epoch{0};
+        query_gt.ifilter_epoch(libdnf::sack::QueryCmp::GT, epoch);
+        CPPUNIT_ASSERT_EQUAL(5lu, query_gt.size());
+        libdnf::rpm::SolvQuery query_lte(sack.get());
+        query_lte.ifilter_epoch(libdnf::sack::QueryCmp::LTE, epoch);
+        CPPUNIT_ASSERT_EQUAL(286lu, query_lte.size());
+    }
+
+    {
+        // Test QueryCmp::EQ - string
+        libdnf::rpm::SolvQuery query(sack.get());
+        std::vector<std::string> epoch{"1"};
+        query.ifilter_epoch(libdnf::sack::QueryCmp::EQ, epoch);
+        CPPUNIT_ASSERT_EQUAL(5lu, query.size());
+    }
+
+    {
+        // Test QueryCmp::EQ - string with leading zero does not match
+        libdnf::rpm::SolvQuery query(sack.get());
+        std::vector<std::string> epoch{"01"};
+        query.ifilter_epoch(libdnf::sack::QueryCmp::EQ, epoch);
+        CPPUNIT_ASSERT_EQUAL(0lu, query.size());
+    }
+
+    {
+        // Test QueryCmp::GLOB - string
+        libdnf::rpm::SolvQuery query(sack.get());
+        std::vector<std::string> epoch{"[1-9]"};
+        query.ifilter_epoch(libdnf::sack::QueryCmp::GLOB, epoch);
+        CPPUNIT_ASSERT_EQUAL(5lu, query.size());
+    }
+}
+
 void RpmSolvQueryTest::test_ifilter_version() {
     std::set<std::string> nevras{"CQRlib-0:1.1.1-4.fc29.src", "CQRlib-0:1.1.1-4.fc29.x86_64"};
 
@@ -243,6 +298,17 @@ void RpmSolvQueryTest::test_ifilter_version() {
             CPPUNIT_ASSERT(nevras.find(pkg.get_full_nevra()) != nevras.end());
         }
     }
+
+    {
+        // Test QueryCmp::GT and QueryCmp::LTE - together they select all packages
+        libdnf::rpm::SolvQuery query_gt(sack.get());
+        std::vector<std::string> version{"1.1.1"};
+        query_gt.ifilter_version(libdnf::sack::QueryCmp::GT, version);
+        libdnf::rpm::SolvQuery query_lte(sack.get());
+        query_lte.ifilter_version(libdnf::sack::QueryCmp::LTE, version);
+        CPPUNIT_ASSERT(query_lte.size() > 2);
+        CPPUNIT_ASSERT_EQUAL(291lu, query_gt.size() + query_lte.size());
+    }
 }
 
 void RpmSolvQueryTest::test_ifilter_release() {
@@ -305,6 +371,129 @@ void RpmSolvQueryTest::test_ifilter_requires() {
     }
 }
 
+void RpmSolvQueryTest::test_parallel_filters() {
+    auto to_nevras = [](libdnf::rpm::SolvQuery & query) {
+        std::set<std::string> nevras;
+        for (auto pkg : query.get_package_set()) {
+            nevras.insert(pkg.get_full_nevra());
+        }
+        return nevras;
+    };
+
+    libdnf::rpm::SolvQuery query(sack.get());
+    libdnf::rpm::SolvQuery query_parallel(sack.get());
+    query_parallel.set_num_workers(4);
+
+    {
+        // Test filelist filter
+        auto serial = query;
+        auto parallel = query_parallel;
+        std::vector<std::string> files{"/etc/*"};
+        serial.ifilter_file(libdnf::sack::QueryCmp::GLOB, files);
+        parallel.ifilter_file(libdnf::sack::QueryCmp::GLOB, files);
+        CPPUNIT_ASSERT_EQUAL(1lu, parallel.size());
+        CPPUNIT_ASSERT(to_nevras(serial) == to_nevras(parallel));
+    }
+
+    {
+        // Test summary filter
+        auto serial = query;
+        auto parallel = query_parallel;
+        std::vector<std::string> summaries{"library"};
+        serial.ifilter_summary(libdnf::sack::QueryCmp::ICONTAINS, summaries);
+        parallel.ifilter_summary(libdnf::sack::QueryCmp::ICONTAINS, summaries);
+        CPPUNIT_ASSERT_EQUAL(6lu, parallel.size());
+        CPPUNIT_ASSERT(to_nevras(serial) == to_nevras(parallel));
+    }
+
+    {
+        // Test requires filter
+        auto serial = query;
+        auto parallel = query_parallel;
+        std::vector<std::string> requires {"wget"};
+        serial.ifilter_requires(libdnf::sack::QueryCmp::EQ, requires);
+        parallel.ifilter_requires(libdnf::sack::QueryCmp::EQ, requires);
+        CPPUNIT_ASSERT_EQUAL(1lu, parallel.size());
+        CPPUNIT_ASSERT(to_nevras(serial) == to_nevras(parallel));
+    }
+}
+
+void RpmSolvQueryTest::test_repo_added_after_query() {
+    // fill the cached solvable maps and lists of the sack
+    {
+        libdnf::rpm::SolvQuery query(sack.get());
+        CPPUNIT_ASSERT_EQUAL(291lu, query.size());
+        std::vector<std::string> nevras{"CQRlib-1.1.1-4.fc29.x86_64"};
+        query.ifilter_nevra(libdnf::sack::QueryCmp::EQ, nevras);
+        CPPUNIT_ASSERT_EQUAL(1lu, query.size());
+    }
+
+    // the caches must pick up solvables of the newly loaded repository
+    add_repo("package-test-baseurl");
+
+    libdnf::rpm::SolvQuery query(sack.get());
+    CPPUNIT_ASSERT_EQUAL(292lu, query.size());
+
+    {
+        auto query_nevra = query;
+        std::vector<std::string> nevras{"test-package-1:1.0-1.x86_64", "CQRlib-1.1.1-4.fc29.x86_64"};
+        query_nevra.ifilter_nevra(libdnf::sack::QueryCmp::EQ, nevras);
+        CPPUNIT_ASSERT_EQUAL(2lu, query_nevra.size());
+    }
+
+    {
+        auto query_epoch = query;
+        std::vector<unsigned long> epoch{1};
+        query_epoch.ifilter_epoch(libdnf::sack::QueryCmp::EQ, epoch);
+        CPPUNIT_ASSERT_EQUAL(6lu, query_epoch.size());
+    }
+}
+
+void RpmSolvQueryTest::test_explain() {
+    // profiling is disabled by default
+    {
+        libdnf::rpm::SolvQuery query(sack.get());
+        std::vector<std::string> names{"CQRlib"};
+        query.ifilter_name(libdnf::sack::QueryCmp::EQ, names);
+        CPPUNIT_ASSERT(query.explain().empty());
+    }
+
+    libdnf::rpm::SolvQuery query(sack.get());
+    query.set_profiling(true);
+
+    std::vector<std::string> names{"CQRlib"};
+    query.ifilter_name(libdnf::sack::QueryCmp::EQ, names);
+    std::vector<std::string> arches{"x86_64"};
+    query.ifilter_arch(libdnf::sack::QueryCmp::EQ, arches);
+    // ifilter_provides() with strings calls ifilter_provides() with ReldepList, it is recorded once
+    std::vector<std::string> provides{"CQRlib"};
+    query.ifilter_provides(libdnf::sack::QueryCmp::EQ, provides);
+    CPPUNIT_ASSERT_EQUAL(1lu, query.size());
+
+    auto & stats = query.explain();
+    CPPUNIT_ASSERT_EQUAL(3lu, stats.size());
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ifilter_name"), std::string(stats[0].filter_name));
+    CPPUNIT_ASSERT(stats[0].cmp_type == libdnf::sack::QueryCmp::EQ);
+    CPPUNIT_ASSERT_EQUAL(291lu, stats[0].input_size);
+    CPPUNIT_ASSERT_EQUAL(2lu, stats[0].output_size);
+    CPPUNIT_ASSERT(stats[0].indexed);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ifilter_arch"), std::string(stats[1].filter_name));
+    CPPUNIT_ASSERT_EQUAL(2lu, stats[1].input_size);
+    CPPUNIT_ASSERT_EQUAL(1lu, stats[1].output_size);
+    CPPUNIT_ASSERT(!stats[1].indexed);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ifilter_provides"), std::string(stats[2].filter_name));
+    CPPUNIT_ASSERT_EQUAL(1lu, stats[2].input_size);
+    CPPUNIT_ASSERT_EQUAL(1lu, stats[2].output_size);
+    CPPUNIT_ASSERT(stats[2].indexed);
+
+    // a copy of the query inherits the recorded statistics
+    libdnf::rpm::SolvQuery query_copy(query);
+    CPPUNIT_ASSERT_EQUAL(3lu, query_copy.explain().size());
+}
+
 void RpmSolvQueryTest::test_resolve_pkg_spec() {
     {
         // Test NA
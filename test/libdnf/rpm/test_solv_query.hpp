@@ -34,10 +34,14 @@ class RpmSolvQueryTest : public RepoFixture {
     CPPUNIT_TEST(test_size);
     CPPUNIT_TEST(test_ifilter_name);
     CPPUNIT_TEST(test_ifilter_nevra);
+    CPPUNIT_TEST(test_ifilter_epoch);
     CPPUNIT_TEST(test_ifilter_version);
     CPPUNIT_TEST(test_ifilter_release);
     CPPUNIT_TEST(test_ifilter_provides);
     CPPUNIT_TEST(test_ifilter_requires);
+    CPPUNIT_TEST(test_parallel_filters);
+    CPPUNIT_TEST(test_repo_added_after_query);
+    CPPUNIT_TEST(test_explain);
     CPPUNIT_TEST(test_resolve_pkg_spec);
 #endif
 
@@ -52,10 +56,14 @@ public:
     void test_size();
     void test_ifilter_name();
     void test_ifilter_nevra();
+    void test_ifilter_epoch();
     void test_ifilter_version();
     void test_ifilter_release();
     void test_ifilter_provides();
     void test_ifilter_requires();
+    void test_parallel_filters();
+    void test_repo_added_after_query();
+    void test_explain();
     void test_resolve_pkg_spec();
 };
 
@@ -21,6 +21,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/utils/set.hpp"
 
+#include <vector>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(SetTest);
 
 
@@ -152,3 +154,65 @@ void SetTest::test_set_binary_operators() {
     CPPUNIT_ASSERT(((s1 - s2) == libdnf::Set<int>{1, 6}));
     CPPUNIT_ASSERT(((s1 ^ s2) == libdnf::Set<int>{1, 2, 6}));
 }
+
+// test the sorted vector backed set, the operations must give the same results as with std::set
+void SetTest::test_sorted_vector_set() {
+    // duplicates and unsorted objects in the initializer list
+    libdnf::SortedVectorSet<int> s1{6, 1, 4, 1};
+    CPPUNIT_ASSERT_EQUAL(s1.size(), static_cast<size_t>(3));
+    CPPUNIT_ASSERT((s1.get_data() == std::vector<int>{1, 4, 6}));
+
+    s1.add(2);
+    s1.add(4);
+    CPPUNIT_ASSERT((s1 == libdnf::SortedVectorSet<int>{1, 2, 4, 6}));
+    s1.remove(4);
+    s1.remove(5);
+    CPPUNIT_ASSERT((s1 == libdnf::SortedVectorSet<int>{1, 2, 6}));
+    CPPUNIT_ASSERT(s1.contains(2) && !s1.contains(4));
+
+    libdnf::SortedVectorSet<int> s2{1, 4, 6};
+    libdnf::SortedVectorSet<int> s3{2, 4};
+    CPPUNIT_ASSERT(((s2 | s3) == libdnf::SortedVectorSet<int>{1, 2, 4, 6}));
+    CPPUNIT_ASSERT(((s2 & s3) == libdnf::SortedVectorSet<int>{4}));
+    CPPUNIT_ASSERT(((s2 - s3) == libdnf::SortedVectorSet<int>{1, 6}));
+    CPPUNIT_ASSERT(((s2 ^ s3) == libdnf::SortedVectorSet<int>{1, 2, 6}));
+    CPPUNIT_ASSERT((libdnf::SortedVectorSet<int>{4}.is_subset(s2)));
+    CPPUNIT_ASSERT(s2.is_superset(libdnf::SortedVectorSet<int>{1, 6}));
+}
+
+
+namespace {
+
+// Runs union, intersection and difference of two half overlapping sets with 10, 1k and 100k objects
+template <typename SetT>
+void set_operators_performance() {
+    for (int size : {10, 1000, 100000}) {
+        SetT s1;
+        SetT s2;
+        for (int i = 0; i < size; ++i) {
+            s1.add(i);
+            s2.add(i + size / 2);
+        }
+        // repeat the operations to get comparable run times for all sizes
+        for (int i = 0; i < 1000000 / size; ++i) {
+            auto result_union = s1 | s2;
+            auto result_intersection = s1 & s2;
+            auto result_difference = s1 - s2;
+            CPPUNIT_ASSERT_EQUAL(result_union.size(), static_cast<size_t>(size + size / 2));
+            CPPUNIT_ASSERT_EQUAL(result_intersection.size(), static_cast<size_t>(size - size / 2));
+            CPPUNIT_ASSERT_EQUAL(result_difference.size(), static_cast<size_t>(size / 2));
+        }
+    }
+}
+
+}  // namespace
+
+
+void SetTest::test_set_operators_performance() {
+    set_operators_performance<libdnf::Set<int>>();
+}
+
+
+void SetTest::test_sorted_vector_set_operators_performance() {
+    set_operators_performance<libdnf::SortedVectorSet<int>>();
+}
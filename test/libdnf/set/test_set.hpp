@@ -27,12 +27,22 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 class SetTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(SetTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_set_basics);
     CPPUNIT_TEST(test_set_equal_operator);
     CPPUNIT_TEST(test_set_assignment_operator);
     CPPUNIT_TEST(test_set_unary_operators);
     CPPUNIT_TEST(test_set_unary_operators);
     CPPUNIT_TEST(test_set_binary_operators);
+    CPPUNIT_TEST(test_sorted_vector_set);
+#endif
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_set_operators_performance);
+    CPPUNIT_TEST(test_sorted_vector_set_operators_performance);
+#endif
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -45,6 +55,10 @@ public:
     void test_set_unary_operators();
     void test_set_unary_methods();
     void test_set_binary_operators();
+    void test_sorted_vector_set();
+
+    void test_set_operators_performance();
+    void test_sorted_vector_set_operators_performance();
 
 private:
 };
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_decompress.hpp"
+
+#include "libdnf/utils/decompress.hpp"
+
+#include <cstdio>
+#include <string>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UtilsDecompressTest);
+
+
+namespace {
+
+std::string read_all(std::FILE * fp) {
+    std::string result;
+    char buf[1000];
+    std::size_t len;
+    while ((len = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+        result.append(buf, len);
+    }
+    std::fclose(fp);
+    return result;
+}
+
+}  // namespace
+
+
+void UtilsDecompressTest::test_open_decompressed() {
+    std::string path = PROJECT_SOURCE_DIR "/test/libdnf/rpm/repos-data/dnf-ci-fedora/repodata/primary.xml.gz";
+
+    // with the zero buffer size the file is decompressed by the reader, the result is the reference
+    auto expected = read_all(libdnf::utils::open_decompressed(path, 0));
+    CPPUNIT_ASSERT(expected.find("<metadata") != std::string::npos);
+    for (std::size_t buffer_size : {1ul, 4096ul, libdnf::utils::DECOMPRESS_BUFFER_SIZE}) {
+        CPPUNIT_ASSERT(expected == read_all(libdnf::utils::open_decompressed(path, buffer_size)));
+    }
+
+    // the decompressing thread is stopped when the stream is closed before the end of data
+    auto fp = libdnf::utils::open_decompressed(path, 16);
+    char buf[100];
+    CPPUNIT_ASSERT_EQUAL(sizeof(buf), std::fread(buf, 1, sizeof(buf), fp));
+    CPPUNIT_ASSERT_EQUAL(0, std::fclose(fp));
+
+    CPPUNIT_ASSERT(libdnf::utils::open_decompressed(PROJECT_SOURCE_DIR "/test/does-not-exist.gz") == nullptr);
+}
@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_thread_pool.hpp"
+
+#include "libdnf/utils/thread_pool.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UtilsThreadPoolTest);
+
+
+void UtilsThreadPoolTest::test_run() {
+    libdnf::utils::ThreadPool pool;
+
+    // each task is run exactly once, the calling thread runs tasks too
+    std::vector<int> counts(8, 0);
+    pool.run(counts.size(), [&counts](std::size_t idx) { ++counts[idx]; });
+    CPPUNIT_ASSERT(counts == std::vector<int>(8, 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(7), pool.size());
+
+    // the threads are reused by the next batches
+    for (int batch = 0; batch < 10; ++batch) {
+        pool.run(4, [&counts](std::size_t idx) { ++counts[idx]; });
+    }
+    CPPUNIT_ASSERT_EQUAL(11, counts[0]);
+    CPPUNIT_ASSERT_EQUAL(1, counts[7]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(7), pool.size());
+
+    // an exception of a task is rethrown after all tasks finished
+    std::vector<int> finished(4, 0);
+    CPPUNIT_ASSERT_THROW(
+        pool.run(
+            finished.size(),
+            [&finished](std::size_t idx) {
+                finished[idx] = 1;
+                if (idx == 2) {
+                    throw std::runtime_error("task failed");
+                }
+            }),
+        std::runtime_error);
+    CPPUNIT_ASSERT(finished == std::vector<int>(4, 1));
+}
@@ -0,0 +1,39 @@
+/*
+Copyright (C) 2020 Red Hat, Inc.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_TEST_UTILS_THREAD_POOL_HPP
+#define LIBDNF_TEST_UTILS_THREAD_POOL_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class UtilsThreadPoolTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(UtilsThreadPoolTest);
+    CPPUNIT_TEST(test_run);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_run();
+};
+
+
+#endif  // LIBDNF_TEST_UTILS_THREAD_POOL_HPP
@@ -0,0 +1,55 @@
+# Copyright (C) 2020 Red Hat, Inc.
+#
+# This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+#
+# Libdnf is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# Libdnf is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+import unittest
+import os
+
+import libdnf
+
+
+class TestSolvSack(unittest.TestCase):
+    def setUp(self):
+        self.base = libdnf.base.Base()
+
+        # Sets path to cache directory.
+        cwd = os.getcwd()
+        self.base.get_config().cachedir().set(libdnf.conf.Option.Priority_RUNTIME, cwd)
+
+        self.repo_sack = libdnf.rpm.RepoSack(self.base)
+        self.sack = libdnf.rpm.SolvSack(self.base)
+
+        repo = self.repo_sack.new_repo("dnf-ci-fedora")
+        repo_path = os.path.join(cwd, "../../../test/libdnf/rpm/repos-data/dnf-ci-fedora/")
+        repo.get_config().baseurl().set(libdnf.conf.Option.Priority_RUNTIME, "file://" + repo_path)
+        repo.load()
+        self.sack.load_repo(repo.get(), libdnf.rpm.SolvSack.LoadRepoFlags_NONE)
+
+    def test_get_memory_usage(self):
+        usage = self.sack.get_memory_usage()
+        self.assertEqual(len(usage.repos), 1)
+        repo_usage = usage.repos[0]
+        self.assertEqual(repo_usage.repo_id, "dnf-ci-fedora")
+        self.assertGreater(repo_usage.solvables, 0)
+        self.assertGreater(repo_usage.dependencies, 0)
+        self.assertEqual(repo_usage.filelists, 0)
+        self.assertGreater(usage.string_pool, 0)
+        self.assertGreaterEqual(usage.get_total(), repo_usage.get_total() + usage.string_pool)
+
+        # the provides index is created by the first query
+        query = libdnf.rpm.SolvQuery(self.sack)
+        query.ifilter_provides(libdnf.common.QueryCmp_EQ, libdnf.common.VectorString(["glibc"]))
+        self.assertGreater(self.sack.get_memory_usage().whatprovides, 0)